@@ -0,0 +1,103 @@
+/* --------------------------------------------------------------
+   Table-Driven Sensor Acquisition
+   Every ADC channel is one row in a constant table:
+       channel, attenuation, rate, conversion, filter, threshold, sink
+   A single task samples all of them. Channels with the same period
+   form a rate group and are read back-to-back in one batch, then
+   filtered, checked against their threshold and handed to their sink.
+   Each group keeps an absolute deadline; after every batch a one-shot
+   esp_timer is armed for the earliest one, so the task wakes once per
+   due batch whatever the periods are: 17 ms and 500 ms cost about 61
+   wakeups a second, not the 1000 of a common-divisor tick.
+
+   Adding a sensor is a new table row, not a new task, stack and
+   priority. Sinks run on the acquisition task, so they must be short:
+   give a semaphore, send to a queue, publish a snapshot, or print.
+---------------------------------------------------------------*/
+#ifndef ACQUISITION_H
+#define ACQUISITION_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "driver/adc.h"
+
+#define ACQ_MAX_CHANNELS 16        // Table rows supported by one scheduler
+#define ACQ_MAX_RATE_GROUPS 8      // Distinct sampling periods
+#define ACQ_MAX_FILTER_WINDOW 16   // Moving-average depth limit
+#define ACQ_TASK_STACK 4096        // One stack for every channel, sized for printf in sinks
+
+typedef enum {
+    ACQ_FILTER_NONE,
+    ACQ_FILTER_MOVING_AVERAGE,     // Mean of the last `window` values
+    ACQ_FILTER_EXPONENTIAL,        // y += alpha * (x - y)
+} acq_filter_kind_t;
+
+typedef struct {
+    acq_filter_kind_t kind;
+    uint8_t window;                // ACQ_FILTER_MOVING_AVERAGE, 1..ACQ_MAX_FILTER_WINDOW
+    float alpha;                   // ACQ_FILTER_EXPONENTIAL, 0..1
+} acq_filter_t;
+
+typedef enum {
+    ACQ_THRESHOLD_NONE,
+    ACQ_THRESHOLD_ABOVE,           // Alarm while the filtered value is above level
+    ACQ_THRESHOLD_BELOW,           // Alarm while the filtered value is below level
+} acq_threshold_kind_t;
+
+typedef struct {
+    acq_threshold_kind_t kind;
+    float level;
+    float hysteresis;              // Alarm clears only once the value is this far back past level
+} acq_threshold_t;
+
+struct acq_channel;
+
+typedef struct {
+    const struct acq_channel *channel;
+    int raw;                       // ADC reading, 0-4095
+    float value;                   // After conversion
+    float filtered;                // After the filter; the threshold is checked on this
+    bool alarm;                    // Threshold currently violated
+    bool alarm_changed;            // alarm differs from the previous sample (edge)
+    uint32_t sequence;             // Samples taken on this channel
+    TickType_t tick;               // When the batch was read
+} acq_sample_t;
+
+typedef float (*acq_convert_t)(int raw);
+typedef void (*acq_sink_t)(const acq_sample_t *sample, void *context);
+
+typedef struct acq_channel {
+    const char *name;
+    adc1_channel_t adc_channel;
+    adc_atten_t attenuation;
+    uint32_t period_ms;
+    acq_convert_t convert;         // NULL: value is the raw reading
+    acq_filter_t filter;
+    acq_threshold_t threshold;
+    acq_sink_t sink;
+    void *sink_context;
+} acq_channel_t;
+
+typedef struct {
+    uint32_t wakeups;              // Timer wakeups of the acquisition task
+    uint32_t overruns;             // Periods skipped because a group was served a whole period late
+    uint8_t rate_groups;
+} acq_stats_t;
+
+/*
+ * Configures the ADC for every row, builds the rate groups and starts the
+ * acquisition task and its timer. The table must outlive the scheduler.
+ * Returns false if the table exceeds the limits above or the task or
+ * timer cannot be created; nothing is left running in that case.
+ */
+bool acq_start(const acq_channel_t *table, size_t count, UBaseType_t priority, BaseType_t core);
+
+void acq_get_stats(acq_stats_t *stats);
+
+/* The acquisition task, e.g. to name it in a trace or watch it. */
+TaskHandle_t acq_get_task(void);
+
+#endif /* ACQUISITION_H */
@@ -0,0 +1,201 @@
+/***********************************************************************
+ * Audited Mutex - see audited_mutex.h
+ ***********************************************************************/
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include "audited_mutex.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+
+static audited_mutex_t *registry = NULL;
+
+bool audited_mutex_init(audited_mutex_t *mutex, const char *name, uint32_t budget_us)
+{
+    memset(mutex, 0, sizeof(*mutex));
+    mutex->handle = xSemaphoreCreateMutex();   // FreeRTOS mutexes implement priority inheritance
+    if (mutex->handle == NULL) {
+        return false;
+    }
+    mutex->name = name;
+    mutex->budget_us = budget_us;
+    mutex->next = registry;
+    registry = mutex;
+    return true;
+}
+
+BaseType_t audited_mutex_take(audited_mutex_t *mutex, TickType_t timeout)
+{
+    UBaseType_t priority = uxTaskPriorityGet(NULL);
+
+    /* Owner fields are read without the lock; a stale name only mislabels the worst case.
+     * The holder is sampled before the take, so contended is a best-effort flag. */
+    bool contended = xSemaphoreGetMutexHolder(mutex->handle) != NULL;
+    const char *owner = mutex->owner_name;
+    UBaseType_t owner_priority = mutex->owner_priority;
+
+    int64_t start = esp_timer_get_time();
+    if (xSemaphoreTake(mutex->handle, timeout) != pdTRUE) {
+        __atomic_add_fetch(&mutex->timeouts, 1, __ATOMIC_RELAXED);   // Not the owner, so no lock held
+        return pdFALSE;
+    }
+    int64_t now = esp_timer_get_time();
+    uint32_t wait = (uint32_t)(now - start);
+
+    /* Owner from here on: statistics are protected by the mutex itself */
+    mutex->owner_name = pcTaskGetName(NULL);
+    mutex->owner_priority = priority;
+    mutex->acquired_at_us = now;
+
+    mutex->takes++;
+    mutex->total_wait_us += wait;
+    if (contended) {
+        mutex->contended++;
+        if (priority > owner_priority) {
+            mutex->inversions++;
+        }
+    }
+    if (priority < configMAX_PRIORITIES) {
+        mutex->waited_at_priority[priority] = true;
+        if (wait > mutex->max_wait_by_priority[priority]) {
+            mutex->max_wait_by_priority[priority] = wait;
+        }
+    }
+    if (wait > mutex->max_wait_us) {
+        mutex->max_wait_us = wait;
+        mutex->worst_waiter = mutex->owner_name;
+        mutex->worst_waiter_priority = priority;
+        mutex->worst_owner = contended ? owner : NULL;
+        mutex->worst_owner_priority = owner_priority;
+    }
+    return pdTRUE;
+}
+
+void audited_mutex_give(audited_mutex_t *mutex)
+{
+    uint32_t hold = (uint32_t)(esp_timer_get_time() - mutex->acquired_at_us);
+    UBaseType_t base = mutex->owner_priority;
+
+    mutex->total_hold_us += hold;
+    if (hold > mutex->max_hold_us) {
+        mutex->max_hold_us = hold;
+    }
+    if (base < configMAX_PRIORITIES && hold > mutex->max_hold_by_priority[base]) {
+        mutex->max_hold_by_priority[base] = hold;
+    }
+    if (uxTaskPriorityGet(NULL) > base) {
+        mutex->boosted_gives++;   // A higher-priority waiter lent us its priority
+    }
+    xSemaphoreGive(mutex->handle);
+}
+
+/* Longest critical section run by any owner below this priority: the inheritance blocking bound */
+static uint32_t blocking_bound(const audited_mutex_t *m, UBaseType_t priority)
+{
+    uint32_t bound = 0;
+    for (UBaseType_t p = 0; p < priority && p < configMAX_PRIORITIES; p++) {
+        if (m->max_hold_by_priority[p] > bound) {
+            bound = m->max_hold_by_priority[p];
+        }
+    }
+    return bound;
+}
+
+/* Appends to the report buffer; output that does not fit is cut off, never overrun */
+static void report_append(char *buf, size_t size, size_t *len, const char *fmt, ...)
+{
+    if (*len >= size - 1) {
+        return;
+    }
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(buf + *len, size - *len, fmt, args);
+    va_end(args);
+    if (n > 0) {
+        *len += (size_t)n < size - *len ? (size_t)n : size - *len - 1;
+    }
+}
+
+static void format_mutex_stats(const audited_mutex_t *m, char *buf, size_t size, size_t *len)
+{
+    bool over_budget = m->max_wait_us > m->budget_us;
+    uint32_t takes = m->takes ? m->takes : 1;
+
+    report_append(buf, size, len, "%s: takes=%lu contended=%lu inversions=%lu boosted=%lu timeouts=%lu\n",
+                  m->name, (unsigned long)m->takes, (unsigned long)m->contended,
+                  (unsigned long)m->inversions, (unsigned long)m->boosted_gives, (unsigned long)m->timeouts);
+    report_append(buf, size, len, "  wait avg/max %lu/%lu us, hold avg/max %lu/%lu us, budget %lu us -> %s\n",
+                  (unsigned long)(m->total_wait_us / takes), (unsigned long)m->max_wait_us,
+                  (unsigned long)(m->total_hold_us / takes), (unsigned long)m->max_hold_us,
+                  (unsigned long)m->budget_us, over_budget ? "OVER BUDGET" : "OK");
+    if (m->worst_owner != NULL) {
+        report_append(buf, size, len, "  worst wait: %s (prio %u) behind %s (prio %u)\n",
+                      m->worst_waiter, (unsigned)m->worst_waiter_priority,
+                      m->worst_owner, (unsigned)m->worst_owner_priority);
+    }
+    for (UBaseType_t p = 0; p < configMAX_PRIORITIES; p++) {
+        if (m->waited_at_priority[p]) {
+            report_append(buf, size, len, "  prio %u: max wait %lu us, lower-priority hold bound %lu us\n",
+                          (unsigned)p, (unsigned long)m->max_wait_by_priority[p],
+                          (unsigned long)blocking_bound(m, p));
+        }
+    }
+}
+
+void audited_mutex_report(audited_mutex_t *console)
+{
+    static audited_mutex_t copy;                        // Too large for a small task stack
+    static char report[AUDITED_MUTEX_REPORT_SIZE];
+    size_t len = 0;
+
+    /* Format the whole report first, with no console lock held */
+    report_append(report, sizeof(report), &len, "--- MUTEX AUDIT (uptime %lu ms) ---\n",
+                  (unsigned long)pdTICKS_TO_MS(xTaskGetTickCount()));
+    for (audited_mutex_t *m = registry; m != NULL; m = m->next) {
+        /* Copy under the lock itself so the numbers are consistent; not counted */
+        xSemaphoreTake(m->handle, portMAX_DELAY);
+        copy = *m;
+        xSemaphoreGive(m->handle);
+        format_mutex_stats(&copy, report, sizeof(report), &len);
+    }
+    report_append(report, sizeof(report), &len, "--- END MUTEX AUDIT ---\n");
+
+    /* Then write it one line per console hold, so a waiter is blocked for one line at most */
+    for (char *line = report; *line != '\0'; ) {
+        char *end = strchr(line, '\n');
+        size_t line_len = end != NULL ? (size_t)(end - line) + 1 : strlen(line);
+        if (console != NULL) {
+            audited_mutex_take(console, portMAX_DELAY);
+        }
+        fwrite(line, 1, line_len, stdout);
+        if (console != NULL) {
+            audited_mutex_give(console);
+        }
+        line += line_len;
+    }
+}
+
+typedef struct {
+    uint32_t period_ms;
+    audited_mutex_t *console;
+} reporter_config_t;
+
+static reporter_config_t reporter_config;
+
+static void audited_mutex_reporter_task(void *pvParameters)
+{
+    const reporter_config_t *config = (const reporter_config_t *)pvParameters;
+    TickType_t lastWakeTime = xTaskGetTickCount();
+
+    while (1) {
+        vTaskDelayUntil(&lastWakeTime, pdMS_TO_TICKS(config->period_ms));
+        audited_mutex_report(config->console);
+    }
+}
+
+void audited_mutex_start_reporter(uint32_t period_ms, UBaseType_t priority, audited_mutex_t *console)
+{
+    reporter_config.period_ms = period_ms;
+    reporter_config.console = console;
+    xTaskCreate(audited_mutex_reporter_task, "MutexAudit", 3072, &reporter_config, priority, NULL);
+}
@@ -0,0 +1,93 @@
+/***********************************************************************
+ * Audited Mutex
+ * A FreeRTOS mutex (priority inheritance included) that measures how it
+ * is used, so worst-case blocking can be bounded from real data:
+ *   - wait time: from the take call until the lock is acquired,
+ *   - hold time: from acquisition until the give,
+ *   - contention: takes that found the lock already held, with the
+ *     waiter and owner priorities, and priority inversions (a waiter
+ *     of higher priority than the owner); best effort, since the
+ *     holder is sampled just before the take and a lock released or
+ *     taken in between is miscounted either way,
+ *   - inheritance: gives made while the owner ran at a boosted priority.
+ *
+ * Under priority inheritance a task of priority P blocks on a single
+ * lock for at most the longest critical section run by a lower-priority
+ * task. The report prints that bound for every waiting priority next to
+ * the observed worst wait, and flags the lock as OVER BUDGET when a wait
+ * exceeded the lock's budget.
+ *
+ * Statistics are updated by the owner while it holds the lock, so they
+ * need no extra locking. Task context only; never use from an ISR.
+ ***********************************************************************/
+#ifndef AUDITED_MUTEX_H
+#define AUDITED_MUTEX_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AUDITED_MUTEX_REPORT_SIZE 2048   // Formatted report; longer reports are cut off
+
+typedef struct audited_mutex {
+    SemaphoreHandle_t handle;
+    const char *name;
+    uint32_t budget_us;                 // Longest acceptable wait for any task
+
+    /* Current owner, written by the owner after it acquires the lock */
+    const char *owner_name;
+    UBaseType_t owner_priority;         // Owner's priority when it acquired the lock
+    int64_t acquired_at_us;
+
+    /* Statistics */
+    uint32_t takes;
+    uint32_t contended;                 // Takes that found the lock held (best effort, see above)
+    uint32_t inversions;                // Contended takes where the waiter outranked the owner
+    uint32_t boosted_gives;             // Gives made at an inherited (raised) priority
+    uint32_t timeouts;                  // Takes that gave up before acquiring the lock
+    uint64_t total_wait_us;
+    uint64_t total_hold_us;
+    uint32_t max_wait_us;
+    uint32_t max_hold_us;
+    uint32_t max_hold_by_priority[configMAX_PRIORITIES];  // Longest critical section per owner priority
+    uint32_t max_wait_by_priority[configMAX_PRIORITIES];  // Longest wait per waiter priority
+    bool waited_at_priority[configMAX_PRIORITIES];
+
+    /* Context of the worst wait */
+    const char *worst_waiter;
+    UBaseType_t worst_waiter_priority;
+    const char *worst_owner;
+    UBaseType_t worst_owner_priority;
+
+    struct audited_mutex *next;         // Registry of all audited mutexes, for the report
+} audited_mutex_t;
+
+/* Creates the underlying mutex and registers it for reporting. Call before the tasks that use it start. */
+bool audited_mutex_init(audited_mutex_t *mutex, const char *name, uint32_t budget_us);
+
+/* Same contract as xSemaphoreTake / xSemaphoreGive. */
+BaseType_t audited_mutex_take(audited_mutex_t *mutex, TickType_t timeout);
+void audited_mutex_give(audited_mutex_t *mutex);
+
+/*
+ * Prints every registered mutex. The report is formatted into a buffer
+ * first; when console is non-NULL it is then held for one line at a
+ * time, so no line interleaves with other output guarded by it and no
+ * waiter is blocked for more than one line. Those holds are audited
+ * like any other.
+ */
+void audited_mutex_report(audited_mutex_t *console);
+
+/* Creates a task that prints the report every period_ms. */
+void audited_mutex_start_reporter(uint32_t period_ms, UBaseType_t priority, audited_mutex_t *console);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUDITED_MUTEX_H */
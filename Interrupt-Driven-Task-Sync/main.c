@@ -7,9 +7,13 @@
 #include "driver/adc.h"
 #include "esp_log.h"
 #include "math.h"
+#include "audited_mutex.h"
+#include "acquisition.h"
+#include "wcet.h"
+#include "supervisor.h"
 
 // Hardware Pin Definitions
-#define LED_PIN GPIO_NUM_2          // On-board LED or external LED
+#define LED_PIN GPIO_NUM_2          // Supervisor heartbeat LED; fast blink on a missed check-in
 #define LDR_PIN GPIO_NUM_34         // LDR connected to GPIO34 (ADC1_CHANNEL_6)
 #define BUTTON_PIN GPIO_NUM_4       // Push-button for interrupt
 
@@ -19,11 +23,29 @@
 // Task & Buffer Configuration
 #define LOG_BUFFER_SIZE 50          // Store the last 50 sensor readings
 
+// Liveness Supervision: longest gap between check-ins before a task counts as hung
+#define SUPERVISOR_PERIOD_MS 100
+#define HEARTBEAT_HALF_PERIOD_MS 1400     // Same 1.4 s blink as the old heartbeat task
+#define ACQ_CHECKIN_DEADLINE_MS 1000      // Sink runs every 200 ms
+#define GROUND_CMD_WAIT_MS 1000           // GroundCommandTask wakes at least this often to check in
+#define GROUND_CMD_CHECKIN_DEADLINE_MS 3000
+#define TELEMETRY_CHECKIN_DEADLINE_MS 10000 // Runs every 7 s
+
+// Benchmark Configuration: set to 1 (or build with -DWCET_BENCHMARK=1) to time
+// button_isr_handler in isolation instead of running the application
+#ifndef WCET_BENCHMARK
+#define WCET_BENCHMARK 0
+#endif
+#define BUTTON_ISR_BUDGET_US 10     // ISR body budget checked by the benchmark
+
 // Global Variables
 SemaphoreHandle_t xButtonSem;       // Binary semaphore for button press ISR
-SemaphoreHandle_t xLogMutex;        // Mutex to protect the shared log buffer
+audited_mutex_t xLogMutex;          // Mutex to protect the shared log buffer, with blocking-time audit
 int lightSensorLog[LOG_BUFFER_SIZE]; // Buffer to store raw sensor readings
 int logIndex = 0;                   // Current index for the circular buffer
+supervised_task_t xAcqLiveness;     // Check-in counters for the supervisor
+supervised_task_t xGroundCmdLiveness;
+supervised_task_t xTelemetryLiveness;
 
 
 void IRAM_ATTR button_isr_handler(void* arg) {
@@ -37,48 +59,63 @@ void IRAM_ATTR button_isr_handler(void* arg) {
 }
 
 
-void SatelliteHeartbeatTask(void *pvParameters) {
-    bool led_status = false;
-    while (1) {
-        led_status = !led_status;
-        gpio_set_level(LED_PIN, led_status);
-        vTaskDelay(pdMS_TO_TICKS(1400)); // Blink every 1.4 seconds
-    }
+#if WCET_BENCHMARK
+// Empty semaphore before every run, so each run takes the path that gives it
+void ButtonIsrBenchSetup(void *context) {
+    xSemaphoreTake(xButtonSem, 0);
+}
+
+void RunWcetBenchmarks(void) {
+    static const wcet_case_t cases[] = {
+        { "button_isr_handler", button_isr_handler, ButtonIsrBenchSetup, NULL, BUTTON_ISR_BUDGET_US },
+    };
+    wcet_run(cases, sizeof(cases) / sizeof(cases[0]), WCET_DEFAULT_ITERATIONS);
 }
+#endif
 
 
 void TelemetryTransmitTask(void *pvParameters) {
     while (1) {
-        printf("TELEMETRY UPLINK: System status nominal. Timestamp: %lu ms.\n", pdTICKS_TO_MS(xTaskGetTickCount()));
+        printf("TELEMETRY UPLINK: System status %s. Timestamp: %lu ms.\n",
+               supervisor_faulted() ? "SAFE MODE" : "nominal", pdTICKS_TO_MS(xTaskGetTickCount()));
+        supervisor_checkin(&xTelemetryLiveness);
+        supervisor_report_misses();  // Lowest-priority loop, so printing here delays nothing
         vTaskDelay(pdMS_TO_TICKS(7000)); // Run every 7 seconds
     }
 }
 
-void SolarPanelMonitorTask(void *pvParameters) {
-    int raw_value;
-    const TickType_t periodTicks = pdMS_TO_TICKS(200); // Sample every 200 ms
-    TickType_t lastWakeTime = xTaskGetTickCount();
-
-    while (1) {
-        raw_value = adc1_get_raw(LDR_ADC_CHANNEL);
-
-        // Safely update the shared log buffer
-        if (xSemaphoreTake(xLogMutex, portMAX_DELAY) == pdTRUE) {
-            lightSensorLog[logIndex] = raw_value;
-            logIndex = (logIndex + 1) % LOG_BUFFER_SIZE; // Wrap around the buffer
-            xSemaphoreGive(xLogMutex);
-        }
-
-        // Use vTaskDelayUntil for precise periodic execution
-        vTaskDelayUntil(&lastWakeTime, periodTicks);
+// Solar panel sink: called by the acquisition task every 200 ms with a fresh reading.
+// Checking in from here proves the acquisition task is still sampling.
+void SolarPanelLogSink(const acq_sample_t *sample, void *context) {
+    supervisor_checkin(&xAcqLiveness);
+    // Safely update the shared log buffer
+    if (audited_mutex_take(&xLogMutex, portMAX_DELAY) == pdTRUE) {
+        lightSensorLog[logIndex] = sample->raw;
+        logIndex = (logIndex + 1) % LOG_BUFFER_SIZE; // Wrap around the buffer
+        audited_mutex_give(&xLogMutex);
     }
 }
 
+// Sensor channels sampled by the single acquisition task. Add a row per new sensor.
+static const acq_channel_t sensor_channels[] = {
+    {
+        .name = "SolarPanel",
+        .adc_channel = LDR_ADC_CHANNEL,
+        .attenuation = ADC_ATTEN_DB_11,
+        .period_ms = 200,                 // Sample every 200 ms
+        .filter = { .kind = ACQ_FILTER_NONE },
+        .threshold = { .kind = ACQ_THRESHOLD_NONE },
+        .sink = SolarPanelLogSink,
+    },
+};
+
 
 void GroundCommandTask(void *pvParameters) {
     for (;;) {
-        // Wait indefinitely for the semaphore from the ISR (consumes no CPU while waiting)
-        if (xSemaphoreTake(xButtonSem, portMAX_DELAY) == pdTRUE) {
+        supervisor_checkin(&xGroundCmdLiveness);
+        // Wait for the semaphore from the ISR (consumes no CPU while waiting); the bounded
+        // wait lets the task check in with the supervisor while no command arrives
+        if (xSemaphoreTake(xButtonSem, pdMS_TO_TICKS(GROUND_CMD_WAIT_MS)) == pdTRUE) {
             printf("\n--- COMMAND RECEIVED ---\n");
             printf("ACTION: Compressing and dumping sensor logs...\n");
             
@@ -89,10 +126,10 @@ void GroundCommandTask(void *pvParameters) {
             int local_log[LOG_BUFFER_SIZE];
             int current_log_index;
 
-            if (xSemaphoreTake(xLogMutex, portMAX_DELAY) == pdTRUE) {
+            if (audited_mutex_take(&xLogMutex, portMAX_DELAY) == pdTRUE) {
                 memcpy(local_log, lightSensorLog, sizeof(lightSensorLog));
                 current_log_index = logIndex; // Capture the current index
-                xSemaphoreGive(xLogMutex);
+                audited_mutex_give(&xLogMutex);
             }
 
             // Calculate min, max, and average
@@ -119,10 +156,6 @@ void app_main() {
     gpio_reset_pin(LED_PIN);
     gpio_set_direction(LED_PIN, GPIO_MODE_OUTPUT);
 
-    // Configure LDR ADC Pin
-    adc1_config_width(ADC_WIDTH_BIT_12);
-    adc1_config_channel_atten(LDR_ADC_CHANNEL, ADC_ATTEN_DB_11);
-
     // Configure Button Pin for Interrupt
     gpio_reset_pin(BUTTON_PIN);
     gpio_set_direction(BUTTON_PIN, GPIO_MODE_INPUT);
@@ -131,23 +164,51 @@ void app_main() {
     
     // Create a binary semaphore for the button ISR
     xButtonSem = xSemaphoreCreateBinary();
-    // Create a mutex for protecting the shared log buffer
-    xLogMutex = xSemaphoreCreateMutex();
+    // Create a mutex for protecting the shared log buffer. Both critical sections are
+    // a few memory copies, so anything past 1 ms of waiting points at a scheduling problem.
+    audited_mutex_init(&xLogMutex, "xLogMutex", 1000);
+
+#if WCET_BENCHMARK
+    // Benchmark mode: no tasks and no button interrupt, so nothing disturbs the measurements
+    RunWcetBenchmarks();
+    return;
+#endif
 
     gpio_install_isr_service(0);
     // Attach the ISR handler to the button pin
     gpio_isr_handler_add(BUTTON_PIN, button_isr_handler, NULL);
 
+    // Register every supervised task before it can check in
+    supervisor_watch(&xAcqLiveness, "Acquisition", ACQ_CHECKIN_DEADLINE_MS);
+    supervisor_watch(&xGroundCmdLiveness, "GroundCmd", GROUND_CMD_CHECKIN_DEADLINE_MS);
+    supervisor_watch(&xTelemetryLiveness, "Telemetry", TELEMETRY_CHECKIN_DEADLINE_MS);
+
     // All tasks are pinned to Core 1    
     // Priority 1 (Low): Background tasks
-    xTaskCreatePinnedToCore(SatelliteHeartbeatTask, "Heartbeat", 2048, NULL, 1, NULL, 1);
     xTaskCreatePinnedToCore(TelemetryTransmitTask, "Telemetry", 4096, NULL, 1, NULL, 1);
     
-    // Priority 2 (Medium): Periodic data sampling
-    xTaskCreatePinnedToCore(SolarPanelMonitorTask, "SolarMonitor", 4096, NULL, 2, NULL, 1);
+    // Priority 2 (Medium): Periodic data sampling, one acquisition task for every sensor channel
+    if (!acq_start(sensor_channels, sizeof(sensor_channels) / sizeof(sensor_channels[0]), 2, 1)) {
+        printf("ERROR: Sensor acquisition failed to start.\n");
+    }
 
     // Priority 3 (High): High-priority event-driven task
     xTaskCreatePinnedToCore(GroundCommandTask, "GroundCmd", 4096, NULL, 3, NULL, 1);
 
+    // Blocking-time audit: print per-lock wait/hold statistics every 10 seconds
+    audited_mutex_start_reporter(10000, 1, NULL);
+
+    // Liveness supervisor: replaces the heartbeat task. Blinks LED_PIN, feeds the task
+    // watchdog and latches safe mode (fast blink, telemetry reports it) on a missed check-in.
+    const supervisor_config_t supervisorConfig = {
+        .period_ms = SUPERVISOR_PERIOD_MS,
+        .heartbeat_gpio = LED_PIN,
+        .heartbeat_half_period_ms = HEARTBEAT_HALF_PERIOD_MS,
+        .safe_state = NULL,
+    };
+    if (!supervisor_start(&supervisorConfig)) {
+        printf("ERROR: Liveness supervisor failed to start.\n");
+    }
+
     printf("RTOS Application 3 Initialized. System is operational.\n");
 }
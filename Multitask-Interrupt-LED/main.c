@@ -2,29 +2,29 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "driver/gpio.h"
+#include "trace_recorder.h"
+#include "supervisor.h"
 
 #define STATUS_BEACON_PIN GPIO_NUM_4  // Using GPIO4 for the Status Beacon LED
 
-// Task to blink an LED at 2 Hz (500 ms period: 250 ms ON, 250 ms OFF)
-void status_beacon_controller_task(void *pvParameters) {
-    bool is_beacon_active = false; // Tracks if the beacon is currently active (lit)
-    while (1) {
-        // TODO: Set LED pin high or low based on led_on flag; right now it's always on... boring; hint in the commented out print statement
-        gpio_set_level(STATUS_BEACON_PIN, is_beacon_active ? 1 : 0);
-        is_beacon_active = !is_beacon_active;  // toggle state for next time
-        // Optional: printf("LED %s\n", led_on ? "ON" : "OFF");
-        
-        vTaskDelay(pdMS_TO_TICKS(250)); // Delay for 250 ms using MS to Ticks Function vs alternative which is MS / ticks per ms
-    }
-    vTaskDelete(NULL); // We'll never get here; tasks run forever
-}
+// The beacon is driven by the liveness supervisor instead of its own task:
+// 2 Hz (250 ms ON, 250 ms OFF) while telemetry keeps checking in, fast blink once it misses
+#define SUPERVISOR_PERIOD_MS 50
+#define BEACON_HALF_PERIOD_MS 250
+#define TELEMETRY_CHECKIN_DEADLINE_MS 15000  // Telemetry runs every 10 s
+
+supervised_task_t telemetry_liveness;
 
 // Task to print a message every 10000 ms (10 seconds)
 void telemetry_transmit_task(void *pvParameters) { 
     while (1) {
       // TODO: Print a periodic message based on thematic area. Could be a counter or timestamp.
+        trace_user_begin("telemetry");
         printf("Telemetry Uplink: OK. Satellite Uptime: %lu ms\n", 
                (unsigned long)(xTaskGetTickCount() * portTICK_PERIOD_MS));       
+        trace_user_end("telemetry");
+        supervisor_checkin(&telemetry_liveness);
+        supervisor_report_misses();  // Prints a late check-in once this task runs again
         vTaskDelay(pdMS_TO_TICKS(10000)); // Delay for 10000 ms
     }
     vTaskDelete(NULL); // We'll never get here; tasks run forever
@@ -41,8 +41,26 @@ void app_main() {
     // . stack depth, 
     // . parameters [optional] = NULL 
     // . priority [0 = low], 
-    // . pointer referencing this created task [optional] = NULL
+    // . pointer referencing this created task [optional] = NULL (kept here for the trace timeline)
     // Learn more here https://www.freertos.org/Documentation/02-Kernel/04-API-references/01-Task-creation/01-xTaskCreate
-    xTaskCreate(status_beacon_controller_task, "StatusBeaconCtrl", 2048, NULL, 1, NULL);
-    xTaskCreate(telemetry_transmit_task, "TelemetryTx", 2048, NULL, 1, NULL); // Example rename for print_task
+    supervisor_watch(&telemetry_liveness, "TelemetryTx", TELEMETRY_CHECKIN_DEADLINE_MS);
+
+    TaskHandle_t telemetry_handle;
+    xTaskCreate(telemetry_transmit_task, "TelemetryTx", 2048, NULL, 1, &telemetry_handle); // Example rename for print_task
+
+    // Liveness supervisor: one esp_timer callback blinks the beacon, feeds the task
+    // watchdog and latches a fault (fast blink) if telemetry stops checking in
+    const supervisor_config_t supervisor_cfg = {
+        .period_ms = SUPERVISOR_PERIOD_MS,
+        .heartbeat_gpio = STATUS_BEACON_PIN,
+        .heartbeat_half_period_ms = BEACON_HALF_PERIOD_MS,
+        .safe_state = NULL,
+    };
+    if (!supervisor_start(&supervisor_cfg)) {
+        printf("ERROR: liveness supervisor failed to start.\n");
+    }
+
+    // Scheduler trace: type 'd' on the serial console to dump the timeline
+    trace_register_task(telemetry_handle, "TelemetryTx");
+    trace_recorder_start(1);
 }
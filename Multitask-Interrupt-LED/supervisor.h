@@ -0,0 +1,92 @@
+/***********************************************************************
+ * Liveness Supervisor
+ * Replaces a blink-only heartbeat task with a heartbeat that means the
+ * application is actually running. Every safety-relevant task is
+ * registered with a check-in deadline and calls supervisor_checkin()
+ * once per loop. One periodic esp_timer callback then, on every tick:
+ *   - compares each task's check-in counter with the value it saw
+ *     last; a counter that has not moved for longer than the task's
+ *     deadline is a missed check-in (hung, starved or blocked task),
+ *   - drives the heartbeat LED: a steady blink while every task is
+ *     live, a fast blink once a fault has been latched,
+ *   - feeds the task watchdog through its own watchdog user (not by
+ *     subscribing the shared esp_timer task, so other esp_timer users
+ *     do not inherit its timing); the watchdog fires if the supervisor
+ *     itself (or the esp_timer task it runs on) hangs, and resets the
+ *     chip when it is configured to panic. Needs ESP-IDF 5.0 or later.
+ *
+ * The callback itself never prints and the supervisor has no task of
+ * its own: the application calls supervisor_report_misses() from one
+ * of its existing low-priority loops, which prints each miss once.
+ *
+ * A check-in is a relaxed atomic increment of the task's own counter:
+ * no lock and no kernel call, so it is safe from tasks on either core
+ * and from ISRs. Only the supervisor reads the counters.
+ *
+ * A missed check-in latches a fault until reset. The application's
+ * safe-state hook is called on that tick and on every tick after it,
+ * so safe outputs are re-asserted even against tasks that still run.
+ ***********************************************************************/
+#ifndef SUPERVISOR_H
+#define SUPERVISOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SUPERVISOR_NO_LED (-1)
+
+typedef struct supervised_task {
+    const char *name;
+    uint32_t deadline_ms;            // Longest allowed gap between two check-ins
+    volatile uint32_t checkins;      // Bumped by the task, read only by the supervisor
+
+    /* Supervisor-private */
+    uint32_t seen_checkins;
+    int64_t last_progress_us;
+    uint32_t silent_ms_at_miss;      // Set before missed, read by supervisor_report_misses()
+    bool missed;
+    bool reported;                   // supervisor_report_misses() only
+    struct supervised_task *next;
+} supervised_task_t;
+
+/* Runs on the esp_timer task: keep it to a few GPIO writes or flag stores. */
+typedef void (*supervisor_safe_state_t)(const supervised_task_t *culprit, void *context);
+
+typedef struct {
+    uint32_t period_ms;                  // Check interval; also the fault blink rate
+    int heartbeat_gpio;                  // Already configured as an output, or SUPERVISOR_NO_LED
+    uint32_t heartbeat_half_period_ms;   // LED on and off time while every task is live
+    supervisor_safe_state_t safe_state;  // NULL: latch, log and blink only
+    void *context;                       // Passed to safe_state
+} supervisor_config_t;
+
+/* Registers a task. Call for every task before supervisor_start(). */
+void supervisor_watch(supervised_task_t *task, const char *name, uint32_t deadline_ms);
+
+/* Called by the supervised task once per loop iteration. */
+static inline void supervisor_checkin(supervised_task_t *task)
+{
+    __atomic_fetch_add(&task->checkins, 1, __ATOMIC_RELAXED);
+}
+
+/* Starts the check timer. Deadlines count from this call. On failure
+ * nothing is left allocated and no task is supervised. */
+bool supervisor_start(const supervisor_config_t *config);
+
+/* Prints each missed check-in once. Call it from a single low-priority
+ * task's loop; it only reads a flag until a check-in has been missed.
+ * The safe state does not depend on it. */
+void supervisor_report_misses(void);
+
+/* True once any task has missed a check-in; stays true until reset. */
+bool supervisor_faulted(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SUPERVISOR_H */
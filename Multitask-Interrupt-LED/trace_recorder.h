@@ -0,0 +1,111 @@
+/* --------------------------------------------------------------
+   Scheduler Trace Recorder
+   Records task switches, ISR entry/exit, semaphore/queue operations
+   and user-defined spans as 12-byte binary events in a per-core RAM
+   ring. Each record is a handful of stores with interrupts masked on
+   the recording core, so it can stay enabled in production builds.
+
+   Type 'd' on the serial console to dump the ring and 'r' to reset
+   it. Convert a captured serial log with the host tool in
+   Preemptive-Scheduling-Sensor/tools/trace_to_json.c and open the
+   result in https://ui.perfetto.dev or chrome://tracing.
+
+   Kernel hooks (task switch, ISR, queue/semaphore events) need the
+   FreeRTOS trace macros defined before the kernel is compiled. In a
+   local ESP-IDF build add to the project CMakeLists.txt:
+       idf_build_set_property(COMPILE_OPTIONS
+           "-include;${CMAKE_CURRENT_LIST_DIR}/main/trace_recorder.h" APPEND)
+       idf_build_set_property(COMPILE_DEFINITIONS "TRACE_RECORDER_KERNEL_HOOKS" APPEND)
+   The Wokwi online builder cannot do this, so a default build records
+   only the explicit trace_* calls made by the application: no task
+   switches, ISRs or queue/semaphore events, and therefore no view of
+   preemption, starvation or ISR-to-task latency.
+---------------------------------------------------------------*/
+#ifndef TRACE_RECORDER_H
+#define TRACE_RECORDER_H
+
+#ifndef __ASSEMBLER__
+
+#include <stdint.h>
+
+#define TRACE_RING_EVENTS 512        // Events kept per core (power of two), 12 bytes each
+#define TRACE_MAX_NAMES 24           // Registered task/object names
+#define TRACE_CONSOLE_PERIOD_MS 100  // Serial command poll interval
+
+typedef enum {
+    TRACE_EVT_TASK_SWITCHED_IN = 1,  // object: task handle
+    TRACE_EVT_TASK_SWITCHED_OUT,     // object: task handle
+    TRACE_EVT_ISR_ENTER,             // object: interrupt number or ISR id
+    TRACE_EVT_ISR_EXIT,              // object: interrupt number or ISR id
+    TRACE_EVT_QUEUE_SEND,            // object: queue handle (semaphore give)
+    TRACE_EVT_QUEUE_RECEIVE,         // object: queue handle (semaphore take)
+    TRACE_EVT_QUEUE_BLOCK_SEND,      // object: queue handle, task is about to block
+    TRACE_EVT_QUEUE_BLOCK_RECEIVE,   // object: queue handle, task is about to block
+    TRACE_EVT_USER_BEGIN,            // object: label string
+    TRACE_EVT_USER_END,              // object: label string
+} trace_event_type_t;
+
+#define TRACE_ARG_FROM_ISR 0x0001    // Queue operation was the FromISR variant
+
+typedef struct {
+    uint32_t timestamp;   // CPU cycle counter (CCOUNT) of the recording core
+    uint32_t object;      // Handle, interrupt number or label address
+    uint8_t type;         // trace_event_type_t
+    uint8_t core;
+    uint16_t arg;
+} trace_event_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void trace_record(uint8_t type, uint32_t object, uint16_t arg);
+
+/* Kernel hook entry points (IRAM-resident, callable with the scheduler locked) */
+void trace_hook_task_switched_in(void);
+void trace_hook_task_switched_out(void);
+void trace_hook_queue(uint8_t type, void *queue, uint16_t arg);
+
+#ifdef TRACE_RECORDER_KERNEL_HOOKS
+#define traceTASK_SWITCHED_IN()                 trace_hook_task_switched_in()
+#define traceTASK_SWITCHED_OUT()                trace_hook_task_switched_out()
+#define traceISR_ENTER(_n_)                     trace_record(TRACE_EVT_ISR_ENTER, (uint32_t)(_n_), 0)
+#define traceISR_EXIT()                         trace_record(TRACE_EVT_ISR_EXIT, 0, 0)
+#define traceISR_EXIT_TO_SCHEDULER()            trace_record(TRACE_EVT_ISR_EXIT, 0, 0)
+#define traceQUEUE_SEND(pxQueue)                trace_hook_queue(TRACE_EVT_QUEUE_SEND, (pxQueue), 0)
+#define traceQUEUE_SEND_FROM_ISR(pxQueue)       trace_hook_queue(TRACE_EVT_QUEUE_SEND, (pxQueue), TRACE_ARG_FROM_ISR)
+#define traceQUEUE_RECEIVE(pxQueue)             trace_hook_queue(TRACE_EVT_QUEUE_RECEIVE, (pxQueue), 0)
+#define traceQUEUE_RECEIVE_FROM_ISR(pxQueue)    trace_hook_queue(TRACE_EVT_QUEUE_RECEIVE, (pxQueue), TRACE_ARG_FROM_ISR)
+#define traceBLOCKING_ON_QUEUE_SEND(pxQueue)    trace_hook_queue(TRACE_EVT_QUEUE_BLOCK_SEND, (pxQueue), 0)
+#define traceBLOCKING_ON_QUEUE_RECEIVE(pxQueue) trace_hook_queue(TRACE_EVT_QUEUE_BLOCK_RECEIVE, (pxQueue), 0)
+#endif
+
+/*
+ * The application API below avoids FreeRTOS types so this header can be
+ * force-included ahead of the kernel's own headers.
+ */
+
+/* Starts recording and the serial console task ('d' dump, 'r' reset). */
+void trace_recorder_start(unsigned console_priority);
+
+/* Names shown in the timeline; handles that were never registered appear as hex. */
+void trace_register_task(void *task, const char *name);
+void trace_register_object(void *handle, const char *kind, const char *name);
+
+/* Writes the ring to stdout between #TRACE-BEGIN and #TRACE-END markers. */
+void trace_dump(void);
+void trace_reset(void);
+
+/* Application probes; label must be a string literal (its address is recorded). */
+static inline void trace_user_begin(const char *label) { trace_record(TRACE_EVT_USER_BEGIN, (uint32_t)(uintptr_t)label, 0); }
+static inline void trace_user_end(const char *label)   { trace_record(TRACE_EVT_USER_END, (uint32_t)(uintptr_t)label, 0); }
+static inline void trace_isr_enter(uint32_t isr_id)    { trace_record(TRACE_EVT_ISR_ENTER, isr_id, 0); }
+static inline void trace_isr_exit(uint32_t isr_id)     { trace_record(TRACE_EVT_ISR_EXIT, isr_id, 0); }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ASSEMBLER__ */
+
+#endif /* TRACE_RECORDER_H */
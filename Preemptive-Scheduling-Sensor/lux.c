@@ -0,0 +1,15 @@
+/* --------------------------------------------------------------
+   LDR lux conversion - see lux.h
+---------------------------------------------------------------*/
+#include "lux.h"
+#include "math.h"
+
+float ldr_raw_to_lux(int raw) {
+    float Rmeasured;
+    // Using simplified equation R = (10000 * raw) / (4095 - raw)
+    if (4095 - raw == 0) Rmeasured = 0; // Avoid division by zero
+    else Rmeasured = (10000.0 * raw) / (4095.0 - raw);
+    // Using formula lux = pow(50000 / R, 1/gamma) where gamma=0.7
+    if (Rmeasured <= 0) return 0; // Avoid division by zero or log of non-positive
+    return powf(50000.0 / Rmeasured, 1.0 / 0.7);
+}
@@ -0,0 +1,11 @@
+/* --------------------------------------------------------------
+   LDR lux conversion, kept free of ESP-IDF headers so the same
+   code can be benchmarked on the host (tools/wcet_host.c).
+---------------------------------------------------------------*/
+#ifndef LUX_H
+#define LUX_H
+
+// Converts a raw 12-bit LDR reading (10k divider) to lux
+float ldr_raw_to_lux(int raw);
+
+#endif /* LUX_H */
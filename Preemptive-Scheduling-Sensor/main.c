@@ -12,7 +12,10 @@
 // TODO1: ADD IN additional INCLUDES BELOW
 #include "driver/adc.h"
 // TODO1: ADD IN additional INCLUDES ABOVE
-#include "math.h"
+#include "trace_recorder.h"
+#include "acquisition.h"
+#include "lux.h"
+#include "wcet.h"
 
 #define LED_PIN GPIO_NUM_2  // Using GPIO2 for the LED
 
@@ -24,6 +27,12 @@
 #define AVG_WINDOW 10
 #define SENSOR_THRESHOLD_LUX 100 // Threshold for lux warning
 
+// Set to 1 (or build with -DWCET_BENCHMARK=1) to time the lux computation instead of running the tasks
+#ifndef WCET_BENCHMARK
+#define WCET_BENCHMARK 0
+#endif
+#define LUX_BUDGET_US 50 // Per-sample conversion budget checked by the benchmark
+
 
 //TODO9: Adjust Task to blink an LED at 1 Hz (1000 ms period: 500 ms ON, 500 ms OFF);
 //Consider supressing the output
@@ -50,84 +59,69 @@ void print_status_task(void *pvParameters) {
         currentTime = pdTICKS_TO_MS( xTaskGetTickCount() );
         
         // Prints periodic thematic message. Output a timestamp (ms) and period (ms)
+        trace_user_begin("telemetry");
         printf("TELEMETRY UPLINK: OK. Timestamp: %lu ms. Period: %lu ms.\n",currentTime, currentTime-previousTime);
+        trace_user_end("telemetry");
         vTaskDelay(pdMS_TO_TICKS(1000)); // Delay for 1000 ms
     }
     vTaskDelete(NULL); // We'll never get here; tasks run forever
 }
 
-//TODO11: Create new task for sensor reading every 500ms
-void sensor_task(void *pvParameters) {
-    //TODO110 Configure ADC (12-bit width, 0-3.3V range with 11dB attenuation)
-    adc1_config_width(ADC_WIDTH_BIT_12);
-    adc1_config_channel_atten(LDR_ADC_CHANNEL, ADC_ATTEN_DB_11);
-
-    // Variables to compute LUX
-    int raw;
-    float Rmeasured = 0.;
-    float lux = 0.;
-    // Variables for moving average
-    float luxreadings[AVG_WINDOW] = {0};
-    int idx = 0;
-    float sum = 0;
-
-    //TODO11a consider where AVG_WINDOW is defined, it could be here, or global value 
-    // Defined globally via #define
-
-    // Pre-fill the readings array with an initial sample to avoid startup anomaly
-    for(int i = 0; i < AVG_WINDOW; ++i) {
-        raw = adc1_get_raw(LDR_ADC_CHANNEL);
-        // Using simplified equation R = (10000 * raw) / (4095 - raw)
-        if (4095 - raw == 0) Rmeasured = 0; // Avoid division by zero
-        else Rmeasured = (10000.0 * raw) / (4095.0 - raw); //TODO11b/c correct this with the equation seen earlier
-        // Using formula lux = pow(50000 / R, 1/gamma) where gamma=0.7
-        if (Rmeasured <= 0) lux = 0; // Avoid division by zero or log of non-positive
-        else lux = powf(50000.0 / Rmeasured, 1.0 / 0.7); //TODO11d correct this with the equation seen earlier
-        
-        luxreadings[i] = lux;
-        sum += luxreadings[i];
-        vTaskDelay(pdMS_TO_TICKS(50)); // Small delay to allow sensor to settle
+//TODO11: Sensor reading every 500ms
+// The LDR is a row in the acquisition table below; the acquisition task (priority 2)
+// samples it on an esp_timer tick, applies the AVG_WINDOW moving average and calls
+// solar_sensor_sink with the result. More sensors are more rows, not more tasks.
+// The raw-to-lux conversion (ldr_raw_to_lux) lives in lux.c.
+
+//TODO11h Check threshold and print alert if exceeded or below based on context
+// Space theme: Alert if solar intensity drops, indicating possible eclipse.
+// The averaging window ramps up from the first sample, so no pre-fill pass is needed.
+void solar_sensor_sink(const acq_sample_t *sample, void *context) {
+    trace_user_begin("sensor_sample");
+    int avg_lux = (int)sample->filtered;
+    if (sample->alarm) {
+        printf("ALERT!: Solar Intensity Low!. Avg Lux: %d\n", avg_lux);
+    } else {
+        // Print the avg value for debugging and status confirmation
+        printf("SOLAR SENSOR: OK. Avg Lux: %d\n", avg_lux);
     }
+    trace_user_end("sensor_sample");
+}
 
-    const TickType_t periodTicks = pdMS_TO_TICKS(500); // 500 ms period
-    TickType_t lastWakeTime = xTaskGetTickCount(); // initialize last wake time
+static const acq_channel_t sensor_channels[] = {
+    {
+        .name = "LDR",
+        .adc_channel = LDR_ADC_CHANNEL,
+        .attenuation = ADC_ATTEN_DB_11,
+        .period_ms = 500,
+        .convert = ldr_raw_to_lux,
+        .filter = { .kind = ACQ_FILTER_MOVING_AVERAGE, .window = AVG_WINDOW },
+        .threshold = { .kind = ACQ_THRESHOLD_BELOW, .level = SENSOR_THRESHOLD_LUX },
+        .sink = solar_sensor_sink,
+    },
+};
+
+
+#if WCET_BENCHMARK
+// powf's cost depends on its argument, so the conversion is timed across the ADC range
+static const int lux_bench_inputs[] = { 0, 100, 2048, 4000, 4095 };
+static volatile float lux_bench_result;
+
+void lux_bench_body(void *context) {
+    lux_bench_result = ldr_raw_to_lux(*(const int *)context);
+}
 
-    while (1) {
-        // Read current sensor value
-        raw = adc1_get_raw(LDR_ADC_CHANNEL);
-        
-        // Compute LUX
-        // Using simplified equation R = (10000 * raw) / (4095 - raw)
-        if (4095 - raw == 0) Rmeasured = 0; // Avoid division by zero
-        else Rmeasured = (10000.0 * raw) / (4095.0 - raw); //TODO11e/f correct this with the equation seen earlier
-        // Using formula lux = pow(50000 / R, 1/gamma) where gamma=0.7
-        if (Rmeasured <= 0) lux = 0;
-        else lux = powf(50000.0 / Rmeasured, 1.0 / 0.7); //TODO11g correct this with the equation seen earlier
-       
-        // Update moving average buffer 
-        sum -= luxreadings[idx];       // remove oldest value from sum
-        luxreadings[idx] = lux;        // place new reading
-        sum += lux;                 // add new value to sum
-        idx = (idx + 1) % AVG_WINDOW;
-        int avg_lux = (int)(sum / AVG_WINDOW); // compute average
-
-        //TODO11h Check threshold and print alert if exceeded or below based on context
-        // Space theme: Alert if solar intensity drops, indicating possible eclipse.
-        if (avg_lux < SENSOR_THRESHOLD_LUX) {
-            printf("ALERT!: Solar Intensity Low!. Avg Lux: %d\n", avg_lux);
-        } else {
-          //TODO11i
-          // Print the avg value for debugging and status confirmation
-          printf("SOLAR SENSOR: OK. Avg Lux: %d\n", avg_lux);
-        }
-        
-        //TODO11j: Print out time period [to help with answering Eng/Analysis quetionst (hint check Application Solution #1 )
-        //This printout is implicitly handled by the print_status_task, but we ensure this task runs on schedule.
-        
-        //TODO11k Replace vTaskDelay with vTaskDelayUntil with parameters &lastWakeTime and periodTicks
-        vTaskDelayUntil(&lastWakeTime, periodTicks);
-    }
+void run_wcet_benchmarks(void) {
+    static const wcet_case_t cases[] = {
+        { "ldr_raw_to_lux.raw0",    lux_bench_body, NULL, (void *)&lux_bench_inputs[0], LUX_BUDGET_US },
+        { "ldr_raw_to_lux.raw100",  lux_bench_body, NULL, (void *)&lux_bench_inputs[1], LUX_BUDGET_US },
+        { "ldr_raw_to_lux.raw2048", lux_bench_body, NULL, (void *)&lux_bench_inputs[2], LUX_BUDGET_US },
+        { "ldr_raw_to_lux.raw4000", lux_bench_body, NULL, (void *)&lux_bench_inputs[3], LUX_BUDGET_US },
+        { "ldr_raw_to_lux.raw4095", lux_bench_body, NULL, (void *)&lux_bench_inputs[4], LUX_BUDGET_US },
+    };
+    wcet_run(cases, sizeof(cases) / sizeof(cases[0]), WCET_DEFAULT_ITERATIONS);
 }
+#endif
 
 
 void app_main() {
@@ -149,6 +143,12 @@ void app_main() {
     // with parameters LDR_ADC_CHANNEL and ADC_ATTEN_DB_11
     adc1_config_channel_atten(LDR_ADC_CHANNEL, ADC_ATTEN_DB_11);
 
+#if WCET_BENCHMARK
+    // Benchmark mode: the harness runs alone, no tasks are created
+    run_wcet_benchmarks();
+    return;
+#endif
+
     // Instantiate/ Create tasks: 
     // ... (omitting descriptive comments for brevity)
     
@@ -156,14 +156,25 @@ void app_main() {
     // ... (omitting descriptive comments for brevity)
 
     // Priorities: SENSOR (2-High), STATUS (1-Medium), LED (0-Low)
-    xTaskCreatePinnedToCore(led_task, "LED", 2048, NULL, 0, NULL, 1);
-    xTaskCreatePinnedToCore(print_status_task, "STATUS", 2048, NULL, 1, NULL, 1);
+    // Handles are kept so the trace timeline can show task names
+    TaskHandle_t led_handle, status_handle;
+    xTaskCreatePinnedToCore(led_task, "LED", 2048, NULL, 0, &led_handle, 1);
+    xTaskCreatePinnedToCore(print_status_task, "STATUS", 2048, NULL, 1, &status_handle, 1);
 
     // TODO8: Make sure everything still works as expected before moving on to TODO9 (above).
 
     //TODO12 Add in new Sensor task; make sure it has the correct priority to preempt 
-    //the other two tasks. (Stack increased for floating point math).
-    xTaskCreatePinnedToCore(sensor_task, "SENSOR", 4096, NULL, 2, NULL, 1);
+    //the other two tasks. The acquisition task samples every sensor channel.
+    if (!acq_start(sensor_channels, sizeof(sensor_channels) / sizeof(sensor_channels[0]), 2, 1)) {
+        printf("ERROR: Sensor acquisition failed to start.\n");
+    }
+
+    // Scheduler trace: type 'd' on the serial console to dump the timeline.
+    // The console task runs on core 0 so it never perturbs the core 1 schedule.
+    trace_register_task(led_handle, "LED");
+    trace_register_task(status_handle, "STATUS");
+    trace_register_task(acq_get_task(), "Acquisition");
+    trace_recorder_start(1);
 
     //TODO13: Make sure the output is working as expected and move on to the engineering
     //and analysis part of the application. You may need to make modifications for experiments. 
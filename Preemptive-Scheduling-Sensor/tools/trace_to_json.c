@@ -0,0 +1,539 @@
+/* --------------------------------------------------------------
+   Trace dump converter: serial log -> Chrome trace / Perfetto JSON.
+   Runs on the host (Linux/macOS), not on the ESP32.
+
+   Build:  cc -O2 -o trace_to_json trace_to_json.c
+   (one copy serves every project that embeds trace_recorder.c)
+   Usage:  ./trace_to_json <serial.log> [out.json]
+           (reads stdin when the log is "-", writes stdout when out is omitted)
+
+   Capture the serial output after typing 'd' on the console; the last
+   #TRACE-BEGIN ... #TRACE-END block in the log is converted. Open the
+   JSON in https://ui.perfetto.dev or chrome://tracing:
+     - "Cores" shows which task owned each CPU and every ISR,
+     - "Tasks" shows each task's run slices, user spans and the
+       semaphore/queue operations it performed.
+   A summary goes to stderr: CPU share, longest time off the CPU
+   (starvation), longest block per task and object (priority
+   inversion shows up as a long block on a mutex) and the latency
+   from each give-from-ISR to the task that takes it.
+---------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_EVENTS 65536
+#define MAX_NAMES 256
+#define MAX_CORES 2
+#define MAX_TRACKS 128
+#define LINE_SIZE 256
+
+// Must match trace_event_type_t in trace_recorder.h
+enum {
+    EVT_TASK_SWITCHED_IN = 1,
+    EVT_TASK_SWITCHED_OUT,
+    EVT_ISR_ENTER,
+    EVT_ISR_EXIT,
+    EVT_QUEUE_SEND,
+    EVT_QUEUE_RECEIVE,
+    EVT_QUEUE_BLOCK_SEND,
+    EVT_QUEUE_BLOCK_RECEIVE,
+    EVT_USER_BEGIN,
+    EVT_USER_END,
+};
+#define ARG_FROM_ISR 0x0001
+
+#define PID_CORES 1
+#define PID_TASKS 2
+#define TID_ISR_BASE 100     // Core ISR tracks sit next to the core's task track
+
+typedef struct {
+    int core;
+    int type;
+    uint32_t ccount;
+    uint32_t object;
+    unsigned arg;
+    int sequence;        // Dump order, keeps same-timestamp events stable when sorted
+    double time_us;      // Filled in once the per-core clocks are known
+} Event;
+
+typedef struct {
+    uint32_t handle;
+    char name[48];
+} Name;
+
+typedef struct {
+    uint32_t ccount;
+    long long time_us;
+    int valid;
+} Clock;
+
+/* Per-task statistics, indexed by track */
+typedef struct {
+    uint32_t handle;
+    double run_us;
+    double longest_off_us;
+    double last_out_us;       // < 0 until the task has been switched out once
+    unsigned switch_ins;
+    uint32_t blocked_on;      // Object the task is blocked on, 0 if none
+    double blocked_since_us;
+    uint32_t worst_block_object;
+    double worst_block_us;
+} Track;
+
+static Event events[MAX_EVENTS];
+static int event_count = 0;
+static Name names[MAX_NAMES];
+static int name_count = 0;
+static Clock clocks[MAX_CORES];
+static unsigned cpu_mhz = 240;
+static int core_count = 1;
+
+static Track tracks[MAX_TRACKS];
+static int track_count = 0;
+
+/* ===================== PARSING ===================== */
+
+static void reset_trace(void) {
+    event_count = 0;
+    name_count = 0;
+    memset(clocks, 0, sizeof(clocks));
+}
+
+static void parse_line(const char *line) {
+    unsigned core, type, arg;
+    unsigned long ccount, object, handle;
+    long long time_us;
+    char name[48];
+
+    if (strncmp(line, "#TRACE-BEGIN", 12) == 0) {
+        reset_trace();   // Keep only the last dump in the log
+        const char *mhz = strstr(line, "cpu_mhz=");
+        const char *cores = strstr(line, "cores=");
+        if (mhz) cpu_mhz = (unsigned)strtoul(mhz + 8, NULL, 10);
+        if (cores) core_count = atoi(cores + 6);
+        if (core_count < 1 || core_count > MAX_CORES) core_count = MAX_CORES;
+    } else if (sscanf(line, "#CLOCK core=%u ccount=%lx us=%lld", &core, &ccount, &time_us) == 3) {
+        if (core < MAX_CORES) {
+            clocks[core].ccount = (uint32_t)ccount;
+            clocks[core].time_us = time_us;
+            clocks[core].valid = 1;
+        }
+    } else if (sscanf(line, "#NAME kind=%*s handle=%lx name=%47[^\r\n]", &handle, name) == 2) {
+        if (name_count < MAX_NAMES) {
+            names[name_count].handle = (uint32_t)handle;
+            strcpy(names[name_count].name, name);
+            name_count++;
+        }
+    } else if (sscanf(line, "E %u %x %lx %lx %x", &core, &type, &ccount, &object, &arg) == 5) {
+        if (event_count < MAX_EVENTS && core < MAX_CORES) {
+            Event *e = &events[event_count++];
+            e->core = (int)core;
+            e->type = (int)type;
+            e->ccount = (uint32_t)ccount;
+            e->object = (uint32_t)object;
+            e->arg = arg;
+            e->sequence = event_count - 1;
+        }
+    }
+}
+
+/*
+ * Converts cycle counts to microseconds. CCOUNT is per core and wraps
+ * every 2^32 cycles (~17.9 s at 240 MHz), so each core's events are
+ * unwrapped in order and anchored to the #CLOCK sample taken at dump
+ * time, which pairs that core's CCOUNT with the shared esp_timer clock.
+ * Gaps longer than one wrap period between consecutive events cannot be
+ * recovered.
+ */
+static void assign_times(void) {
+    double base = 0;
+    int have_base = 0;
+
+    for (int core = 0; core < MAX_CORES; core++) {
+        uint64_t unwrapped = 0;
+        uint32_t previous = 0;
+        int first = 1, last = -1;
+
+        for (int i = 0; i < event_count; i++) {
+            if (events[i].core != core) continue;
+            if (!first) unwrapped += (uint32_t)(events[i].ccount - previous);
+            first = 0;
+            previous = events[i].ccount;
+            events[i].time_us = (double)unwrapped;   // Cycles for now
+            last = i;
+        }
+        if (last < 0) continue;
+
+        double end_cycles = (double)unwrapped;
+        double end_us = 0;
+        if (clocks[core].valid) {
+            end_cycles += (uint32_t)(clocks[core].ccount - previous);
+            end_us = (double)clocks[core].time_us;
+        }
+        for (int i = 0; i < event_count; i++) {
+            if (events[i].core != core) continue;
+            events[i].time_us = end_us - (end_cycles - events[i].time_us) / cpu_mhz;
+            if (!have_base || events[i].time_us < base) {
+                base = events[i].time_us;
+                have_base = 1;
+            }
+        }
+    }
+    for (int i = 0; i < event_count; i++) {
+        events[i].time_us -= base;
+    }
+}
+
+static int compare_time(const void *a, const void *b) {
+    const Event *ea = a, *eb = b;
+    if (ea->time_us != eb->time_us) return ea->time_us < eb->time_us ? -1 : 1;
+    return ea->sequence - eb->sequence;
+}
+
+/* ===================== NAMES AND TRACKS ===================== */
+
+static const char *find_name(uint32_t handle) {
+    for (int i = 0; i < name_count; i++) {
+        if (names[i].handle == handle) {
+            return names[i].name;
+        }
+    }
+    return NULL;
+}
+
+/* Registered name, or the handle in hex. Returns a static buffer. */
+static const char *object_name(uint32_t handle) {
+    static char buffer[4][48];
+    static int next = 0;
+    const char *name = find_name(handle);
+    if (name) return name;
+    char *out = buffer[next++ & 3];
+    snprintf(out, sizeof(buffer[0]), "0x%08lx", (unsigned long)handle);
+    return out;
+}
+
+static int task_track(uint32_t handle) {
+    for (int i = 0; i < track_count; i++) {
+        if (tracks[i].handle == handle) return i;
+    }
+    if (track_count == MAX_TRACKS) return MAX_TRACKS - 1;
+    memset(&tracks[track_count], 0, sizeof(Track));
+    tracks[track_count].handle = handle;
+    tracks[track_count].last_out_us = -1;
+    return track_count++;
+}
+
+/* ===================== JSON OUTPUT ===================== */
+
+static FILE *out;
+static int first_json = 1;
+
+static void json_begin(void) {
+    fputs(first_json ? "\n  " : ",\n  ", out);
+    first_json = 0;
+}
+
+/* Writes s as a quoted JSON string; names come from the device and may hold anything */
+static void emit_string(const char *s) {
+    fputc('"', out);
+    for (; *s != '\0'; s++) {
+        unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') {
+            fputc('\\', out);
+            fputc(c, out);
+        } else if (c < 0x20) {
+            fprintf(out, "\\u%04x", c);
+        } else {
+            fputc(c, out);
+        }
+    }
+    fputc('"', out);
+}
+
+static void emit_metadata(int pid, int tid, const char *what, const char *name) {
+    json_begin();
+    fprintf(out, "{\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"name\":", pid, tid);
+    emit_string(what);
+    fputs(",\"args\":{\"name\":", out);
+    emit_string(name);
+    fputs("}}", out);
+}
+
+static void emit_slice(int pid, int tid, const char *name, const char *cat, double start, double end) {
+    json_begin();
+    fprintf(out, "{\"ph\":\"X\",\"pid\":%d,\"tid\":%d,\"name\":", pid, tid);
+    emit_string(name);
+    fputs(",\"cat\":", out);
+    emit_string(cat);
+    fprintf(out, ",\"ts\":%.3f,\"dur\":%.3f}", start, end - start);
+}
+
+static void emit_span(int pid, int tid, char phase, const char *name, double ts) {
+    json_begin();
+    fprintf(out, "{\"ph\":\"%c\",\"pid\":%d,\"tid\":%d,\"name\":", phase, pid, tid);
+    emit_string(name);
+    fprintf(out, ",\"cat\":\"user\",\"ts\":%.3f}", ts);
+}
+
+static void emit_instant(int pid, int tid, const char *name, const char *object, double ts) {
+    json_begin();
+    fprintf(out, "{\"ph\":\"i\",\"s\":\"t\",\"pid\":%d,\"tid\":%d,\"name\":", pid, tid);
+    emit_string(name);
+    fprintf(out, ",\"cat\":\"kernel\",\"ts\":%.3f,\"args\":{\"object\":", ts);
+    emit_string(object);
+    fputs("}}", out);
+}
+
+/* ===================== ISR-TO-TASK LATENCY ===================== */
+
+#define MAX_PENDING_GIVES 32
+
+typedef struct {
+    uint32_t object;
+    double time_us;
+} PendingGive;
+
+typedef struct {
+    uint32_t object;
+    unsigned count;
+    double total_us;
+    double worst_us;
+} Latency;
+
+static PendingGive pending[MAX_PENDING_GIVES];
+static int pending_count = 0;
+static Latency latencies[MAX_NAMES];
+static int latency_count = 0;
+
+static void record_isr_give(uint32_t object, double t) {
+    for (int i = 0; i < pending_count; i++) {
+        if (pending[i].object == object) return;   // Earliest unconsumed give wins
+    }
+    if (pending_count < MAX_PENDING_GIVES) {
+        pending[pending_count].object = object;
+        pending[pending_count].time_us = t;
+        pending_count++;
+    }
+}
+
+static void record_task_take(uint32_t object, double t) {
+    for (int i = 0; i < pending_count; i++) {
+        if (pending[i].object != object) continue;
+        double latency = t - pending[i].time_us;
+        pending[i] = pending[--pending_count];
+
+        int slot = 0;
+        while (slot < latency_count && latencies[slot].object != object) slot++;
+        if (slot == latency_count) {
+            if (latency_count == MAX_NAMES) return;
+            memset(&latencies[latency_count++], 0, sizeof(Latency));
+            latencies[slot].object = object;
+        }
+        latencies[slot].count++;
+        latencies[slot].total_us += latency;
+        if (latency > latencies[slot].worst_us) latencies[slot].worst_us = latency;
+        return;
+    }
+}
+
+/* ===================== CONVERSION ===================== */
+
+static void convert(void) {
+    uint32_t running[MAX_CORES] = { 0 };
+    double running_since[MAX_CORES];
+    int has_running[MAX_CORES] = { 0 };
+    uint32_t isr_id[MAX_CORES] = { 0 };
+    double isr_since[MAX_CORES];
+    int in_isr[MAX_CORES] = { 0 };
+    double end_time = event_count ? events[event_count - 1].time_us : 0;
+
+    fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", out);
+    emit_metadata(PID_CORES, 0, "process_name", "Cores");
+    emit_metadata(PID_TASKS, 0, "process_name", "Tasks");
+    for (int core = 0; core < core_count; core++) {
+        char label[32];
+        snprintf(label, sizeof(label), "Core %d", core);
+        emit_metadata(PID_CORES, core, "thread_name", label);
+        snprintf(label, sizeof(label), "Core %d ISRs", core);
+        emit_metadata(PID_CORES, TID_ISR_BASE + core, "thread_name", label);
+    }
+
+    for (int i = 0; i < event_count; i++) {
+        const Event *e = &events[i];
+        int core = e->core;
+        double t = e->time_us;
+        int tid = has_running[core] ? task_track(running[core]) : -1;
+
+        switch (e->type) {
+        case EVT_TASK_SWITCHED_IN: {
+            int track = task_track(e->object);
+            running[core] = e->object;
+            running_since[core] = t;
+            has_running[core] = 1;
+            tracks[track].switch_ins++;
+            if (tracks[track].last_out_us >= 0 && t - tracks[track].last_out_us > tracks[track].longest_off_us) {
+                tracks[track].longest_off_us = t - tracks[track].last_out_us;
+            }
+            break;
+        }
+        case EVT_TASK_SWITCHED_OUT:
+            if (has_running[core] && running[core] == e->object) {
+                const char *name = object_name(e->object);
+                int track = task_track(e->object);
+                emit_slice(PID_CORES, core, name, "sched", running_since[core], t);
+                emit_slice(PID_TASKS, track + 1, "running", "sched", running_since[core], t);
+                tracks[track].run_us += t - running_since[core];
+                tracks[track].last_out_us = t;
+                has_running[core] = 0;
+            }
+            break;
+        case EVT_ISR_ENTER:
+            isr_id[core] = e->object;
+            isr_since[core] = t;
+            in_isr[core] = 1;
+            break;
+        case EVT_ISR_EXIT:
+            if (in_isr[core]) {
+                char label[32];
+                snprintf(label, sizeof(label), "ISR %lu", (unsigned long)isr_id[core]);
+                emit_slice(PID_CORES, TID_ISR_BASE + core, label, "isr", isr_since[core], t);
+                in_isr[core] = 0;
+            }
+            break;
+        case EVT_QUEUE_SEND:
+        case EVT_QUEUE_RECEIVE: {
+            const char *op = e->type == EVT_QUEUE_SEND ? "give/send" : "take/receive";
+            if (e->arg & ARG_FROM_ISR) {
+                char label[40];
+                snprintf(label, sizeof(label), "%s from ISR", op);
+                emit_instant(PID_CORES, TID_ISR_BASE + core, label, object_name(e->object), t);
+                if (e->type == EVT_QUEUE_SEND) record_isr_give(e->object, t);
+                break;
+            }
+            if (tid >= 0) {
+                emit_instant(PID_TASKS, tid + 1, op, object_name(e->object), t);
+                if (e->type == EVT_QUEUE_RECEIVE) {
+                    record_task_take(e->object, t);
+                    Track *task = &tracks[tid];
+                    if (task->blocked_on == e->object) {
+                        double blocked = t - task->blocked_since_us;
+                        if (blocked > task->worst_block_us) {
+                            task->worst_block_us = blocked;
+                            task->worst_block_object = e->object;
+                        }
+                    }
+                }
+                tracks[tid].blocked_on = 0;
+            }
+            break;
+        }
+        case EVT_QUEUE_BLOCK_SEND:
+        case EVT_QUEUE_BLOCK_RECEIVE:
+            if (tid >= 0) {
+                emit_instant(PID_TASKS, tid + 1, "block", object_name(e->object), t);
+                tracks[tid].blocked_on = e->object;
+                tracks[tid].blocked_since_us = t;
+            }
+            break;
+        case EVT_USER_BEGIN:
+        case EVT_USER_END: {
+            char phase = e->type == EVT_USER_BEGIN ? 'B' : 'E';
+            const char *label = object_name(e->object);
+            if (tid >= 0) emit_span(PID_TASKS, tid + 1, phase, label, t);
+            else emit_span(PID_CORES, core, phase, label, t);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    /* Close slices still open when the dump was taken */
+    for (int core = 0; core < core_count; core++) {
+        if (has_running[core]) {
+            int track = task_track(running[core]);
+            emit_slice(PID_CORES, core, object_name(running[core]), "sched", running_since[core], end_time);
+            emit_slice(PID_TASKS, track + 1, "running", "sched", running_since[core], end_time);
+            tracks[track].run_us += end_time - running_since[core];
+        }
+    }
+    for (int i = 0; i < track_count; i++) {
+        emit_metadata(PID_TASKS, i + 1, "thread_name", object_name(tracks[i].handle));
+    }
+    fputs("\n]}\n", out);
+}
+
+static void print_summary(void) {
+    double span = event_count ? events[event_count - 1].time_us - events[0].time_us : 0;
+
+    fprintf(stderr, "%d events over %.3f ms at %u MHz\n\n", event_count, span / 1000.0, cpu_mhz);
+    fprintf(stderr, "%-16s %8s %10s %14s %14s  %s\n",
+            "task", "cpu %", "switches", "max off (ms)", "max block(ms)", "blocked on");
+    for (int i = 0; i < track_count; i++) {
+        const Track *task = &tracks[i];
+        fprintf(stderr, "%-16s %8.2f %10u %14.3f %14.3f  %s\n",
+                object_name(task->handle),
+                span > 0 ? 100.0 * task->run_us / (span * core_count) : 0.0,
+                task->switch_ins, task->longest_off_us / 1000.0, task->worst_block_us / 1000.0,
+                task->worst_block_us > 0 ? object_name(task->worst_block_object) : "-");
+    }
+    if (latency_count > 0) {
+        fprintf(stderr, "\n%-16s %8s %12s %12s\n", "ISR -> task via", "count", "avg (us)", "max (us)");
+        for (int i = 0; i < latency_count; i++) {
+            fprintf(stderr, "%-16s %8u %12.1f %12.1f\n", object_name(latencies[i].object),
+                    latencies[i].count, latencies[i].total_us / latencies[i].count, latencies[i].worst_us);
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <serial.log|-> [out.json]\n", argv[0]);
+        return 1;
+    }
+
+    FILE *in = strcmp(argv[1], "-") == 0 ? stdin : fopen(argv[1], "r");
+    if (!in) {
+        perror(argv[1]);
+        return 1;
+    }
+    char line[LINE_SIZE];
+    int in_block = 0, complete = 0;
+    while (fgets(line, sizeof(line), in)) {
+        // Serial monitors may prefix lines with timestamps; start at the marker
+        char *start = strchr(line, '#');
+        char *event = strstr(line, "E ");
+        if (start && strncmp(start, "#TRACE-BEGIN", 12) == 0) {
+            in_block = 1;
+            complete = 0;
+        }
+        if (!in_block) continue;
+        if (start && strncmp(start, "#TRACE-END", 10) == 0) {
+            in_block = 0;
+            complete = 1;
+            continue;
+        }
+        parse_line(start ? start : (event ? event : line));
+    }
+    if (in != stdin) fclose(in);
+
+    if (!complete || event_count == 0) {
+        fprintf(stderr, "No complete #TRACE-BEGIN ... #TRACE-END block with events found\n");
+        return 1;
+    }
+
+    assign_times();
+    qsort(events, event_count, sizeof(Event), compare_time);
+
+    out = argc > 2 ? fopen(argv[2], "w") : stdout;
+    if (!out) {
+        perror(argv[2]);
+        return 1;
+    }
+    convert();
+    if (out != stdout) fclose(out);
+    print_summary();
+    return 0;
+}
@@ -0,0 +1,43 @@
+/* --------------------------------------------------------------
+   Host run of the lux conversion benchmark
+
+   Times ldr_raw_to_lux() with the same harness and inputs as the
+   WCET_BENCHMARK build of main.c, but on the development machine,
+   so a change to the conversion can be checked without a board:
+
+       cc -O2 -o wcet_host tools/wcet_host.c wcet.c lux.c -lm
+       ./wcet_host [iterations]
+
+   Host numbers are TSC ticks (x86) or nanoseconds and only show
+   relative cost; the budget that matters is the one measured on
+   the ESP32. The exit status is the number of cases over budget.
+---------------------------------------------------------------*/
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include "../lux.h"
+#include "../wcet.h"
+
+#define LUX_BUDGET_US 50   // Same budget as main.c
+
+static const int lux_bench_inputs[] = { 0, 100, 2048, 4000, 4095 };
+static volatile float lux_bench_result;
+
+static void lux_bench_body(void *context)
+{
+    lux_bench_result = ldr_raw_to_lux(*(const int *)context);
+}
+
+int main(int argc, char **argv)
+{
+    static const wcet_case_t cases[] = {
+        { "ldr_raw_to_lux.raw0",    lux_bench_body, NULL, (void *)&lux_bench_inputs[0], LUX_BUDGET_US },
+        { "ldr_raw_to_lux.raw100",  lux_bench_body, NULL, (void *)&lux_bench_inputs[1], LUX_BUDGET_US },
+        { "ldr_raw_to_lux.raw2048", lux_bench_body, NULL, (void *)&lux_bench_inputs[2], LUX_BUDGET_US },
+        { "ldr_raw_to_lux.raw4000", lux_bench_body, NULL, (void *)&lux_bench_inputs[3], LUX_BUDGET_US },
+        { "ldr_raw_to_lux.raw4095", lux_bench_body, NULL, (void *)&lux_bench_inputs[4], LUX_BUDGET_US },
+    };
+    uint32_t iterations = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : WCET_DEFAULT_ITERATIONS;
+
+    return wcet_run(cases, sizeof(cases) / sizeof(cases[0]), iterations);
+}
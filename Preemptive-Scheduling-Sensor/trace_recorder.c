@@ -0,0 +1,213 @@
+/* --------------------------------------------------------------
+   Scheduler Trace Recorder - see trace_recorder.h
+---------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdbool.h>
+#include "trace_recorder.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_attr.h"
+#include "esp_ipc.h"
+#include "esp_timer.h"
+#include "esp_idf_version.h"
+#include "rom/ets_sys.h"
+#include "xtensa/hal.h"
+
+typedef struct {
+    uint32_t handle;
+    const char *kind;    // "task", "mutex", "sem", "queue"
+    const char *name;
+} trace_name_t;
+
+typedef struct {
+    uint32_t ccount;
+    int64_t time_us;
+} trace_clock_t;
+
+// Per-core rings: each core only ever writes its own ring, so recording
+// needs no cross-core lock, just interrupts masked on the local core.
+static DRAM_ATTR trace_event_t trace_ring[portNUM_PROCESSORS][TRACE_RING_EVENTS];
+static DRAM_ATTR uint32_t trace_head[portNUM_PROCESSORS];
+static DRAM_ATTR volatile bool trace_enabled = false;
+
+static trace_name_t trace_names[TRACE_MAX_NAMES];
+static int trace_name_count = 0;
+static trace_clock_t trace_clocks[portNUM_PROCESSORS];
+
+/* ===================== RECORDING ===================== */
+
+void IRAM_ATTR trace_record(uint8_t type, uint32_t object, uint16_t arg)
+{
+    if (!trace_enabled) {
+        return;
+    }
+    UBaseType_t saved = portSET_INTERRUPT_MASK_FROM_ISR();
+    int core = xPortGetCoreID();
+    uint32_t head = trace_head[core];
+    trace_event_t *event = &trace_ring[core][head & (TRACE_RING_EVENTS - 1)];
+
+    event->timestamp = xthal_get_ccount();
+    event->object = object;
+    event->type = type;
+    event->core = (uint8_t)core;
+    event->arg = arg;
+    trace_head[core] = head + 1;
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(saved);
+}
+
+void IRAM_ATTR trace_hook_task_switched_in(void)
+{
+    trace_record(TRACE_EVT_TASK_SWITCHED_IN, (uint32_t)(uintptr_t)xTaskGetCurrentTaskHandle(), 0);
+}
+
+void IRAM_ATTR trace_hook_task_switched_out(void)
+{
+    trace_record(TRACE_EVT_TASK_SWITCHED_OUT, (uint32_t)(uintptr_t)xTaskGetCurrentTaskHandle(), 0);
+}
+
+void IRAM_ATTR trace_hook_queue(uint8_t type, void *queue, uint16_t arg)
+{
+    trace_record(type, (uint32_t)(uintptr_t)queue, arg);
+}
+
+/* ===================== NAMES ===================== */
+
+static void add_name(uint32_t handle, const char *kind, const char *name)
+{
+    if (trace_name_count < TRACE_MAX_NAMES) {
+        trace_names[trace_name_count].handle = handle;
+        trace_names[trace_name_count].kind = kind;
+        trace_names[trace_name_count].name = name;
+        trace_name_count++;
+    }
+}
+
+void trace_register_task(void *task, const char *name)
+{
+    add_name((uint32_t)(uintptr_t)task, "task", name);
+}
+
+void trace_register_object(void *handle, const char *kind, const char *name)
+{
+    add_name((uint32_t)(uintptr_t)handle, kind, name);
+}
+
+/* ===================== DUMP ===================== */
+
+/* Runs on each core to pair its cycle counter with the shared microsecond clock */
+static void sample_clock(void *arg)
+{
+    trace_clock_t *clock = (trace_clock_t *)arg;
+    UBaseType_t saved = portSET_INTERRUPT_MASK_FROM_ISR();
+    clock->ccount = xthal_get_ccount();
+    clock->time_us = esp_timer_get_time();
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(saved);
+}
+
+static uint32_t first_retained(int core)
+{
+    uint32_t head = trace_head[core];
+    return head > TRACE_RING_EVENTS ? head - TRACE_RING_EVENTS : 0;
+}
+
+/* User labels are string literals, so their text can be printed straight from the recorded address */
+static void dump_label_names(void)
+{
+    uint32_t printed[TRACE_MAX_NAMES];
+    int printed_count = 0;
+
+    for (int core = 0; core < portNUM_PROCESSORS; core++) {
+        for (uint32_t i = first_retained(core); i < trace_head[core]; i++) {
+            const trace_event_t *e = &trace_ring[core][i & (TRACE_RING_EVENTS - 1)];
+            if (e->type != TRACE_EVT_USER_BEGIN) {
+                continue;
+            }
+            bool seen = false;
+            for (int n = 0; n < printed_count && !seen; n++) {
+                seen = (printed[n] == e->object);
+            }
+            if (!seen && printed_count < TRACE_MAX_NAMES) {
+                printed[printed_count++] = e->object;
+                printf("#NAME kind=label handle=%08lx name=%s\n",
+                       (unsigned long)e->object, (const char *)(uintptr_t)e->object);
+            }
+        }
+    }
+}
+
+void trace_dump(void)
+{
+    trace_enabled = false;   // Freeze the rings while they are printed
+
+    for (int core = 0; core < portNUM_PROCESSORS; core++) {
+        esp_ipc_call_blocking(core, sample_clock, &trace_clocks[core]);
+    }
+
+    printf("\n#TRACE-BEGIN version=1 cpu_mhz=%lu cores=%d\n",
+           (unsigned long)ets_get_cpu_frequency(), portNUM_PROCESSORS);
+    for (int core = 0; core < portNUM_PROCESSORS; core++) {
+        printf("#CLOCK core=%d ccount=%08lx us=%lld\n", core,
+               (unsigned long)trace_clocks[core].ccount, (long long)trace_clocks[core].time_us);
+    }
+    for (int i = 0; i < trace_name_count; i++) {
+        printf("#NAME kind=%s handle=%08lx name=%s\n", trace_names[i].kind,
+               (unsigned long)trace_names[i].handle, trace_names[i].name);
+    }
+    dump_label_names();
+
+    for (int core = 0; core < portNUM_PROCESSORS; core++) {
+        for (uint32_t i = first_retained(core); i < trace_head[core]; i++) {
+            const trace_event_t *e = &trace_ring[core][i & (TRACE_RING_EVENTS - 1)];
+            printf("E %d %02x %08lx %08lx %04x\n", e->core, e->type,
+                   (unsigned long)e->timestamp, (unsigned long)e->object, e->arg);
+        }
+    }
+    printf("#TRACE-END\n");
+
+    trace_enabled = true;
+}
+
+void trace_reset(void)
+{
+    trace_enabled = false;
+    for (int core = 0; core < portNUM_PROCESSORS; core++) {
+        trace_head[core] = 0;
+    }
+    trace_enabled = true;
+}
+
+/* ===================== CONSOLE ===================== */
+
+/* Polls the serial console; stdin is non-blocking under ESP-IDF's default UART VFS */
+static void trace_console_task(void *pvParameters)
+{
+    while (1) {
+        int c = getchar();
+        if (c == 'd' || c == 'D') {
+            trace_dump();
+        } else if (c == 'r' || c == 'R') {
+            trace_reset();
+            printf("Trace buffer reset.\n");
+        }
+        vTaskDelay(pdMS_TO_TICKS(TRACE_CONSOLE_PERIOD_MS));
+    }
+}
+
+void trace_recorder_start(unsigned console_priority)
+{
+    for (int core = 0; core < portNUM_PROCESSORS; core++) {
+        static const char *const idle_names[] = { "IDLE0", "IDLE1" };
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 1, 0)
+        trace_register_task(xTaskGetIdleTaskHandleForCore(core), idle_names[core]);
+#else
+        trace_register_task(xTaskGetIdleTaskHandleForCPU(core), idle_names[core]);   // Deprecated in 5.1
+#endif
+    }
+
+    TaskHandle_t console;
+    xTaskCreatePinnedToCore(trace_console_task, "TraceConsole", 3072, NULL,
+                            console_priority, &console, 0);
+    trace_register_task(console, "TraceConsole");
+
+    trace_enabled = true;
+}
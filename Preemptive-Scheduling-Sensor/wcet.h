@@ -0,0 +1,54 @@
+/***********************************************************************
+ * WCET Micro-Benchmark Harness
+ * Measures execution time of ISR and task bodies in isolation so task
+ * priorities, periods and ISR budgets can be set from data instead of
+ * guesses. Each case is run many times under two conditions:
+ *   - warm: the body has just run, code and data are cached,
+ *   - cold: a buffer larger than the cache is read before every run
+ *           (on the ESP32 a flash-resident buffer, which evicts the
+ *           flash cache that holds non-IRAM code and constants).
+ *
+ * Time is counted in cycles: CCOUNT on the ESP32, the TSC (rdtsc) on
+ * x86 hosts, clock_gettime nanoseconds elsewhere. The measurement
+ * overhead (an empty body) is subtracted. On the ESP32 interrupts are
+ * masked while a body runs, so preemption is excluded.
+ *
+ * For every case and condition the harness prints a percentile table
+ * and histogram, then one machine-readable line:
+ *   WCET {"case":"...","cache":"cold","n":2000,...,"max_us":1.9,"budget_us":20,"pass":true}
+ * A final "WCET-SUMMARY pass=N fail=M" line lets a captured log be
+ * checked with grep. Budgets are compared against the observed maximum;
+ * this is a measured high-water mark, not a static WCET proof.
+ ***********************************************************************/
+#ifndef WCET_H
+#define WCET_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define WCET_DEFAULT_ITERATIONS 2000   // Timed runs per case and cache condition
+#define WCET_HISTOGRAM_BINS 10
+#define WCET_EVICT_BYTES (64 * 1024)   // ESP32 flash cache is 32 KB per core
+
+typedef void (*wcet_body_t)(void *context);
+
+typedef struct {
+    const char *name;
+    wcet_body_t body;          // Unit under test
+    wcet_body_t setup;         // Optional, untimed, before every run: reset state so each run takes the same path
+    void *context;             // Passed to body and setup
+    float budget_us;           // Observed maximum must stay within this
+} wcet_case_t;
+
+/* Runs every case warm and cold. Returns the number of (case, condition) pairs over budget. */
+int wcet_run(const wcet_case_t *cases, size_t count, uint32_t iterations);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WCET_H */
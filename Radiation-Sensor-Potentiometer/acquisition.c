@@ -0,0 +1,217 @@
+/* --------------------------------------------------------------
+   Table-Driven Sensor Acquisition - see acquisition.h
+---------------------------------------------------------------*/
+#include <stdint.h>
+#include <string.h>
+#include "acquisition.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+
+typedef struct {
+    float window[ACQ_MAX_FILTER_WINDOW];
+    float sum;
+    uint8_t index;
+    uint8_t filled;                // Values in the window so far; averages ramp up from the first sample
+    float smoothed;                // Exponential filter state
+    bool alarm;
+    uint32_t sequence;
+} channel_state_t;
+
+typedef struct {
+    uint32_t period_ms;
+    int64_t next_due_us;           // Absolute esp_timer time of the next batch; never drifts
+    uint8_t count;
+    uint8_t members[ACQ_MAX_CHANNELS];
+} rate_group_t;
+
+static const acq_channel_t *channels;
+static channel_state_t states[ACQ_MAX_CHANNELS];
+static rate_group_t groups[ACQ_MAX_RATE_GROUPS];
+static uint8_t group_count;
+static acq_stats_t stats;
+static TaskHandle_t acquisition_task_handle;
+static esp_timer_handle_t acquisition_timer;
+
+static float apply_filter(const acq_filter_t *filter, channel_state_t *state, float value)
+{
+    switch (filter->kind) {
+    case ACQ_FILTER_MOVING_AVERAGE:
+        if (state->filled == filter->window) {
+            state->sum -= state->window[state->index];   // Drop the oldest value
+        } else {
+            state->filled++;
+        }
+        state->window[state->index] = value;
+        state->sum += value;
+        state->index = (state->index + 1) % filter->window;
+        return state->sum / state->filled;
+    case ACQ_FILTER_EXPONENTIAL:
+        state->smoothed = (state->sequence == 0) ? value
+                                                 : state->smoothed + filter->alpha * (value - state->smoothed);
+        return state->smoothed;
+    default:
+        return value;
+    }
+}
+
+static bool check_threshold(const acq_threshold_t *threshold, bool alarm, float value)
+{
+    switch (threshold->kind) {
+    case ACQ_THRESHOLD_ABOVE:
+        return alarm ? value > threshold->level - threshold->hysteresis : value > threshold->level;
+    case ACQ_THRESHOLD_BELOW:
+        return alarm ? value < threshold->level + threshold->hysteresis : value < threshold->level;
+    default:
+        return false;
+    }
+}
+
+/* Reads a whole rate group back-to-back, then filters and dispatches each result */
+static void sample_group(const rate_group_t *group)
+{
+    int raw[ACQ_MAX_CHANNELS];
+    TickType_t now = xTaskGetTickCount();
+
+    for (int i = 0; i < group->count; i++) {
+        raw[i] = adc1_get_raw(channels[group->members[i]].adc_channel);
+    }
+
+    for (int i = 0; i < group->count; i++) {
+        const acq_channel_t *channel = &channels[group->members[i]];
+        channel_state_t *state = &states[group->members[i]];
+        acq_sample_t sample;
+
+        sample.channel = channel;
+        sample.raw = raw[i];
+        sample.value = channel->convert ? channel->convert(raw[i]) : (float)raw[i];
+        sample.filtered = apply_filter(&channel->filter, state, sample.value);
+        sample.alarm = check_threshold(&channel->threshold, state->alarm, sample.filtered);
+        sample.alarm_changed = (sample.alarm != state->alarm);
+        sample.sequence = state->sequence++;
+        sample.tick = now;
+        state->alarm = sample.alarm;
+
+        if (channel->sink) {
+            channel->sink(&sample, channel->sink_context);
+        }
+    }
+}
+
+static void acquisition_timer_callback(void *arg)
+{
+    xTaskNotifyGive(acquisition_task_handle);
+}
+
+static void acquisition_task(void *pvParameters)
+{
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        stats.wakeups++;
+
+        int64_t now = esp_timer_get_time();
+        int64_t earliest = INT64_MAX;
+        for (int g = 0; g < group_count; g++) {
+            rate_group_t *group = &groups[g];
+            if (group->next_due_us <= now) {
+                sample_group(group);
+                // Missed periods are not replayed: the group samples once, late rather than in a burst
+                int64_t period_us = (int64_t)group->period_ms * 1000;
+                group->next_due_us += period_us;
+                while (group->next_due_us <= now) {
+                    group->next_due_us += period_us;
+                    stats.overruns++;
+                }
+            }
+            if (group->next_due_us < earliest) {
+                earliest = group->next_due_us;
+            }
+        }
+
+        // One wakeup per deadline, however the periods relate; the timer has fired, so re-arming cannot fail
+        int64_t delay_us = earliest - esp_timer_get_time();
+        esp_timer_start_once(acquisition_timer, delay_us > 0 ? (uint64_t)delay_us : 0);
+    }
+}
+
+bool acq_start(const acq_channel_t *table, size_t count, UBaseType_t priority, BaseType_t core)
+{
+    if (count == 0 || count > ACQ_MAX_CHANNELS) {
+        return false;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        if (table[i].period_ms == 0 ||
+            (table[i].filter.kind == ACQ_FILTER_MOVING_AVERAGE &&
+             (table[i].filter.window == 0 || table[i].filter.window > ACQ_MAX_FILTER_WINDOW))) {
+            return false;
+        }
+    }
+
+    // Group channels by period, keeping table order within a group
+    group_count = 0;
+    memset(groups, 0, sizeof(groups));
+    for (size_t i = 0; i < count; i++) {
+        int g = 0;
+        while (g < group_count && groups[g].period_ms != table[i].period_ms) {
+            g++;
+        }
+        if (g == group_count) {
+            if (group_count == ACQ_MAX_RATE_GROUPS) {
+                return false;
+            }
+            groups[group_count++].period_ms = table[i].period_ms;
+        }
+        groups[g].members[groups[g].count++] = (uint8_t)i;
+    }
+
+    adc1_config_width(ADC_WIDTH_BIT_12);
+    for (size_t i = 0; i < count; i++) {
+        adc1_config_channel_atten(table[i].adc_channel, table[i].attenuation);
+    }
+
+    channels = table;
+    memset(states, 0, sizeof(states));
+    memset(&stats, 0, sizeof(stats));
+    stats.rate_groups = group_count;
+
+    // Every group is due at once, so each takes its first sample on the first wakeup
+    int64_t start_us = esp_timer_get_time();
+    for (int g = 0; g < group_count; g++) {
+        groups[g].next_due_us = start_us;
+    }
+
+    // Timer first, so a failure never leaves a task waiting for a wakeup that will not come.
+    // It is only started once the task it notifies exists; from then on the task re-arms it.
+    const esp_timer_create_args_t timer_args = {
+        .callback = acquisition_timer_callback,
+        .name = "acquisition",
+    };
+    if (esp_timer_create(&timer_args, &acquisition_timer) != ESP_OK) {
+        return false;
+    }
+    if (xTaskCreatePinnedToCore(acquisition_task, "Acquisition", ACQ_TASK_STACK, NULL,
+                                priority, &acquisition_task_handle, core) != pdPASS) {
+        esp_timer_delete(acquisition_timer);
+        acquisition_timer = NULL;
+        acquisition_task_handle = NULL;
+        return false;
+    }
+    if (esp_timer_start_once(acquisition_timer, 0) != ESP_OK) {
+        vTaskDelete(acquisition_task_handle);
+        acquisition_task_handle = NULL;
+        esp_timer_delete(acquisition_timer);
+        acquisition_timer = NULL;
+        return false;
+    }
+    return true;
+}
+
+void acq_get_stats(acq_stats_t *out)
+{
+    *out = stats;
+}
+
+TaskHandle_t acq_get_task(void)
+{
+    return acquisition_task_handle;
+}
@@ -5,6 +5,8 @@
 #include "driver/gpio.h"
 #include "driver/adc.h"
 #include "esp_log.h"
+#include "audited_mutex.h"
+#include "acquisition.h"
 
 //TODO 8 - Update the code variables and comments to match your selected thematic area!
 // Space Systems Scenario: Monitor radiation levels and respond to ground-control commands.
@@ -39,14 +41,13 @@
 // Handles for semaphores and mutex - you'll initialize these in the main program
 SemaphoreHandle_t sem_ground_control_button; // Binary semaphore for button presses
 SemaphoreHandle_t sem_radiation_event;     // Counting semaphore for radiation threshold exceedances
-SemaphoreHandle_t print_mutex;             // Mutex to protect console (UART) prints
+audited_mutex_t print_mutex;               // Mutex to protect console (UART) prints, with blocking-time audit
 
 volatile int RADIATION_EVENT_COUNT = 0; //You may not use this value in your logic -- but you can print it if you wish
 
 // Static variables for debouncing and rising edge detection
 static TickType_t last_button_press_time = 0;
 const TickType_t BUTTON_DEBOUNCE_TIME_MS = 200; // 200ms debounce time
-static bool radiation_threshold_exceeded_prev = false; // For rising edge detection of sensor events
 
 //TODO 0b: Set heartbeat to cycle once per second (on for one second, off for one second)
 //Find TODO 0c
@@ -62,35 +63,38 @@ void system_status_monitor_task(void *pvParameters) {
 }
 
 
-void radiation_sensor_monitor_task(void *pvParameters) {
-    while (1) {
-        int current_radiation_level = adc1_get_raw(RADIATION_SENSOR_ADC_CHANNEL);
-
-        //TODO 2: Add serial print to log the raw sensor value (mutex protected)
-        //Hint: use xSemaphoreTake( ... which semaphore ...) and printf
-        // Protect console print with a mutex to prevent garbled output
-        xSemaphoreTake(print_mutex, portMAX_DELAY);
-        printf("Radiation Sensor: Current Level = %d\n", current_radiation_level);
-        xSemaphoreGive(print_mutex);
-
-        // Check if radiation level exceeds threshold and detect rising edge
-        if (current_radiation_level > RADIATION_THRESHOLD) {
-            //TODO 3: prevent spamming by only signaling on rising edge; See prior application #3 for help!
-            if (!radiation_threshold_exceeded_prev) { // Rising edge detected
-                if(RADIATION_EVENT_COUNT < MAX_COUNT_SEM) { // Prevent overflow of the counter for display purposes
-                    RADIATION_EVENT_COUNT++;
-                }
-                xSemaphoreGive(sem_radiation_event); // Signal a radiation event
-            }
-            radiation_threshold_exceeded_prev = true; // Update previous state
-        } else {
-            radiation_threshold_exceeded_prev = false; // Reset previous state if below threshold
+// Radiation sensor sink: called by the acquisition task every 100ms with a fresh reading.
+// Rising-edge detection is done by the channel's threshold (alarm_changed).
+void radiation_sensor_sink(const acq_sample_t *sample, void *context) {
+    //TODO 2: Add serial print to log the raw sensor value (mutex protected)
+    //Hint: use xSemaphoreTake( ... which semaphore ...) and printf
+    // Protect console print with a mutex to prevent garbled output
+    audited_mutex_take(&print_mutex, portMAX_DELAY);
+    printf("Radiation Sensor: Current Level = %d\n", sample->raw);
+    audited_mutex_give(&print_mutex);
+
+    //TODO 3: prevent spamming by only signaling on rising edge; See prior application #3 for help!
+    if (sample->alarm && sample->alarm_changed) { // Rising edge detected
+        if(RADIATION_EVENT_COUNT < MAX_COUNT_SEM) { // Prevent overflow of the counter for display purposes
+            RADIATION_EVENT_COUNT++;
         }
-
-        vTaskDelay(pdMS_TO_TICKS(100)); // Read sensor every 100ms
+        xSemaphoreGive(sem_radiation_event); // Signal a radiation event
     }
 }
 
+// Sensor channels sampled by the single acquisition task. Add a row per new sensor.
+static const acq_channel_t sensor_channels[] = {
+    {
+        .name = "Radiation",
+        .adc_channel = RADIATION_SENSOR_ADC_CHANNEL,
+        .attenuation = ADC_ATTEN_DB_11,   // Full range attenuation
+        .period_ms = 100,                 // Read sensor every 100ms
+        .filter = { .kind = ACQ_FILTER_NONE },
+        .threshold = { .kind = ACQ_THRESHOLD_ABOVE, .level = RADIATION_THRESHOLD },
+        .sink = radiation_sensor_sink,
+    },
+};
+
 
 void ground_control_button_watch_task(void *pvParameters) {
     while (1) {
@@ -106,9 +110,9 @@ void ground_control_button_watch_task(void *pvParameters) {
 
                 //TODO 4b: Add a console print indicating button was pressed (mutex protected); different message than in event handler
                 // Protect console print with a mutex
-                xSemaphoreTake(print_mutex, portMAX_DELAY);
+                audited_mutex_take(&print_mutex, portMAX_DELAY);
                 printf("Ground Control: Command button pressed!\n");
-                xSemaphoreGive(print_mutex);
+                audited_mutex_give(&print_mutex);
 
                 last_button_press_time = current_ticks; // Update last press time
             }
@@ -123,9 +127,9 @@ void system_event_handler_task(void *pvParameters) {
         if (xSemaphoreTake(sem_radiation_event, 0)) { // Non-blocking check
             RADIATION_EVENT_COUNT--; // Decrement event counter
 
-            xSemaphoreTake(print_mutex, portMAX_DELAY);
+            audited_mutex_take(&print_mutex, portMAX_DELAY);
             printf("Radiation Alert: Threshold exceeded! Total events: %d\n", RADIATION_EVENT_COUNT);
-            xSemaphoreGive(print_mutex);
+            audited_mutex_give(&print_mutex);
 
             gpio_set_level(LED_RADIATION_ALERT, 1); // Turn red LED on
             vTaskDelay(pdMS_TO_TICKS(100));         // Stay on briefly
@@ -133,9 +137,9 @@ void system_event_handler_task(void *pvParameters) {
         }
 
         if (xSemaphoreTake(sem_ground_control_button, 0)) { // Non-blocking check
-            xSemaphoreTake(print_mutex, portMAX_DELAY);
+            audited_mutex_take(&print_mutex, portMAX_DELAY);
             printf("System Response: Processing ground control command...\n");
-            xSemaphoreGive(print_mutex);
+            audited_mutex_give(&print_mutex);
 
             gpio_set_level(LED_RADIATION_ALERT, 1); // Turn red LED on for longer
             vTaskDelay(pdMS_TO_TICKS(300));         // Indicate system response
@@ -162,9 +166,7 @@ void app_main(void) {
     };
     gpio_config(&btn_conf);
 
-    // Configure ADC
-    adc1_config_width(ADC_WIDTH_BIT_12); // Set ADC to 12-bit resolution (0-4095)
-    adc1_config_channel_atten(RADIATION_SENSOR_ADC_CHANNEL, ADC_ATTEN_DB_11); // Full range attenuation
+    // ADC width (12-bit, 0-4095) and per-channel attenuation are configured by acq_start
 
     // Create sync primitives
     // TODO 0c: Attach the three SemaphoreHandle_t defined earlier 
@@ -174,7 +176,9 @@ void app_main(void) {
     // Move on to TODO 1; remaining TODOs are numbered 1,2,3, 4a 4b, 5, 6 ,7
     sem_ground_control_button = xSemaphoreCreateBinary(); // Binary semaphore for button events
     sem_radiation_event = xSemaphoreCreateCounting(MAX_COUNT_SEM, 0); // Counting semaphore for sensor events
-    print_mutex = xSemaphoreCreateMutex(); // Mutex for protecting shared console output
+    // Mutex for protecting shared console output. Budget: GroundControlBtn polls every
+    // 10 ms, so waiting longer than one poll period behind a printer delays a command.
+    audited_mutex_init(&print_mutex, "print_mutex", 10000);
 
 
     //TODO 5: Test removing the print_mutex around console output (expect interleaving)
@@ -182,10 +186,16 @@ void app_main(void) {
 
     // Create tasks
     xTaskCreate(system_status_monitor_task, "SystemStatus", 2048, NULL, 1, NULL); // Lowest priority
-    xTaskCreate(radiation_sensor_monitor_task, "RadiationSensor", 2048, NULL, 2, NULL);
+    // One task for every sensor channel
+    if (!acq_start(sensor_channels, sizeof(sensor_channels) / sizeof(sensor_channels[0]), 2, tskNO_AFFINITY)) {
+        printf("ERROR: Sensor acquisition failed to start.\n");
+    }
     xTaskCreate(ground_control_button_watch_task, "GroundControlBtn", 2048, NULL, 3, NULL); // Highest priority
     xTaskCreate(system_event_handler_task, "EventHandler", 2048, NULL, 2, NULL);
 
+    // Blocking-time audit: print per-lock wait/hold statistics every 10 seconds
+    audited_mutex_start_reporter(10000, 1, &print_mutex);
+
     //TODO 6: Experiment with changing task priorities to induce or fix starvation
     //E.G> Try: xTaskCreate(sensor_task, ..., 4, ...) and observe heartbeat blinking
     //You should do more than just this example ...
@@ -1,11 +1,14 @@
 // Standard & FreeRTOS Libraries
 #include <WiFi.h>
-#include <WebServer.h>
-#include <uri/UriBraces.h>
+#include "http_server.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/semphr.h"
 #include "freertos/queue.h"
+#include "seqlock.h"
+#include "audited_mutex.h"
+#include "wcet.h"
+#include "supervisor.h"
 
 // --- Mission Configuration ---
 #define WIFI_SSID "Wokwi-GUEST"
@@ -14,36 +17,131 @@
 
 // Hardware Pins
 #define RAD_SENSOR_PIN 34
-#define GREEN_STATUS_LED 26
+#define GREEN_STATUS_LED 26   // Supervisor heartbeat; fast blink once a task misses its check-in
 #define RED_ALERT_LED 27
 #define MODE_BUTTON_PIN 12
 
 // System Parameters
 #define RADIATION_THRESHOLD 3000
+#define COMMAND_QUEUE_DEPTH 8   // Mode commands buffered while eventResponseTask is busy
+#define COMMAND_LOG_SIZE 16     // Recently processed command IDs remembered for deduplication
+#define BUTTON_PENDING_TIMEOUT_MS 2000  // Longest a press waits for its result before the button is re-armed
+#define COMMAND_ID_MAX 0x7FFFFFFFu  // IDs are 31 bits; the deferred-poll token carries the target in bit 31
+
+// Liveness Supervision: longest gap between check-ins before a task counts as hung
+#define SUPERVISOR_PERIOD_MS 100
+#define HEARTBEAT_HALF_PERIOD_MS 1000
+#define SENSOR_CHECKIN_DEADLINE_MS 500    // 17 ms loop
+#define BUTTON_CHECKIN_DEADLINE_MS 500    // 20 ms loop, plus debounce and a log write
+#define EVENT_WAIT_MS 1000                // eventResponseTask wakes at least this often to check in
+#define EVENT_CHECKIN_DEADLINE_MS 3000    // Covers the 1 s alert blink and a command batch
+
+// Set to 1 (or build with -DWCET_BENCHMARK=1) to time the status page handler
+// on the target instead of starting the mission tasks
+#ifndef WCET_BENCHMARK
+#define WCET_BENCHMARK 0
+#endif
+#define STATUS_PAGE_BUDGET_US 1000  // sendHtml runs on the web server task, between client wake-ups
 
 // --- Global Handles & State Variables ---
-WebServer server(80);
 SemaphoreHandle_t sensorAlertSemaphore;
-SemaphoreHandle_t modeChangeSemaphore;
-SemaphoreHandle_t logMutex;
-QueueHandle_t sensorDataQueue;
+audited_mutex_t logMutex;   // Serial log lock, with blocking-time audit
+QueueHandle_t commandQueue;
 enum SystemMode { NORMAL, SHIELDED };
 volatile SystemMode currentMode = NORMAL;
 
+// Latest sensor sample. Written only by sensorMonitorTask and read lock-free by any
+// number of web requests, without a kernel critical section per read.
+struct SensorReading {
+  int level;
+  bool alert;   // level > RADIATION_THRESHOLD, decided together with the sample
+};
+static SEQLOCK_SNAPSHOT(SensorReading) sensorSnapshot;
+
+// Check-in counters of the tasks the liveness supervisor watches
+static supervised_task_t sensorLiveness;
+static supervised_task_t buttonLiveness;
+static supervised_task_t eventLiveness;
+
+// --- Mode Commands ---
+// Commands carry the target state instead of "toggle", so a retried request or two
+// near-simultaneous presses converge on the same mode. The ID lets retries be
+// recognised and answered from the command log instead of being applied again; an ID
+// reused with a different target is a conflict, never a silent success.
+enum CommandType { CMD_SET_MODE };
+enum CommandStatus { CMD_UNKNOWN, CMD_APPLIED, CMD_UNCHANGED };
+
+struct ModeCommand {
+  uint32_t id;
+  CommandType type;
+  SystemMode target;
+};
+
+struct CommandRecord {
+  uint32_t id;
+  SystemMode target;      // What the command asked for, to tell a retry from a reused ID
+  CommandStatus status;
+};
+
+static CommandRecord commandLog[COMMAND_LOG_SIZE];
+static int commandLogNext = 0;
+static portMUX_TYPE commandLogLock = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t nextCommandId = 0;
+
 // --- Utility Functions ---
 void log_message(const char* message) {
-  if (xSemaphoreTake(logMutex, portMAX_DELAY) == pdTRUE) {
+  if (audited_mutex_take(&logMutex, portMAX_DELAY) == pdTRUE) {
     Serial.printf("[%lu] %s\n", xTaskGetTickCount(), message);
-    xSemaphoreGive(logMutex);
+    audited_mutex_give(&logMutex);
   }
 }
 
+uint32_t newCommandId() {
+  uint32_t id;
+  do {
+    id = __atomic_add_fetch(&nextCommandId, 1, __ATOMIC_RELAXED) & COMMAND_ID_MAX;
+  } while (id == 0);  // 0 marks an empty log slot
+  return id;
+}
+
+// Result of a logged command, and the target it was logged with (target may be NULL).
+CommandStatus commandLogFind(uint32_t id, SystemMode *target) {
+  CommandStatus status = CMD_UNKNOWN;
+  portENTER_CRITICAL(&commandLogLock);
+  for (int i = 0; i < COMMAND_LOG_SIZE; i++) {
+    if (commandLog[i].id == id) {
+      status = commandLog[i].status;
+      if (target != NULL) *target = commandLog[i].target;
+      break;
+    }
+  }
+  portEXIT_CRITICAL(&commandLogLock);
+  return status;
+}
+
+void commandLogRecord(uint32_t id, SystemMode target, CommandStatus status) {
+  portENTER_CRITICAL(&commandLogLock);
+  commandLog[commandLogNext].id = id;
+  commandLog[commandLogNext].target = target;
+  commandLog[commandLogNext].status = status;
+  commandLogNext = (commandLogNext + 1) % COMMAND_LOG_SIZE;
+  portEXIT_CRITICAL(&commandLogLock);
+}
+
+bool submitModeCommand(uint32_t id, SystemMode target) {
+  ModeCommand command = { id, CMD_SET_MODE, target };
+  return xQueueSend(commandQueue, &command, 0) == pdTRUE;
+}
+
+const char *modeName(SystemMode mode) {
+  return mode == SHIELDED ? "SHIELDED" : "NORMAL";
+}
+
 // --- Web Interface ---
-void sendHtml() {
-  String response = R"(
+static const char STATUS_PAGE[] = R"(
     <!DOCTYPE html><html><head>
     <title>Radiation Monitor</title>
-    <meta http-equiv="refresh" content="5">
+    <meta http-equiv="refresh" content="5; url=/">
     <meta name="viewport" content="width=device-width, initial-scale=1">
     <style>
       html { font-family: 'Courier New', monospace; text-align: center; background-color:#111; color:#0F0;}
@@ -55,63 +153,148 @@ void sendHtml() {
       .status.normal { color:#0F0; }
       .status.shielded { color:#FF0; }
       .status.alert { color:#F00; animation: blinker 1s linear infinite; }
-      @keyframes blinker { 50% { opacity: 0; } }
+      @keyframes blinker { 50%% { opacity: 0; } }
     </style></head><body>
     <h1>[ESP32 Radiation Monitor]</h1>
     <div class="card">
       <h2>System Status</h2>
-      <p>Current Mode: <span class="status MODE_CLASS">MODE_TEXT</span></p>
-      <p>Radiation Level: SENSOR_VALUE</p>
-      <a href="/toggle_mode" class="btn">Toggle Shielding</a>
+      <p>Current Mode: <span class="status %s">%s</span></p>
+      <p>Radiation Level: %d</p>
+      <p>%s</p>
+      <a href="/toggle_mode?mode=%s&id=%lu" class="btn">Toggle Shielding</a>
     </div></body></html>
   )";
 
-  int sensorSnapshot = 0;
-  xQueuePeek(sensorDataQueue, &sensorSnapshot, 0);
+// Renders straight into the connection's body buffer; no heap String churn per request.
+// The toggle link carries the target state and a fresh command ID, so a browser
+// retry of that link is recognised as the same command.
+void renderStatusPage(HttpResponse &response, const char *ackText) {
+  SensorReading reading;
+  seqlock_read(&sensorSnapshot, &reading);
 
   SystemMode modeSnapshot = currentMode;
-  
-  response.replace("SENSOR_VALUE", String(sensorSnapshot));
 
-  if (sensorSnapshot > RADIATION_THRESHOLD) {
-    response.replace("MODE_CLASS", "alert");
-    response.replace("MODE_TEXT", "ALERT - HIGH RADIATION");
+  const char *modeClass = "normal";
+  const char *modeText = "NORMAL";
+  if (reading.alert) {
+    modeClass = "alert";
+    modeText = "ALERT - HIGH RADIATION";
   } else if (modeSnapshot == SHIELDED) {
-    response.replace("MODE_CLASS", "shielded");
-    response.replace("MODE_TEXT", "SHIELDED");
-  } else {
-    response.replace("MODE_CLASS", "normal");
-    response.replace("MODE_TEXT", "NORMAL");
+    modeClass = "shielded";
+    modeText = "SHIELDED";
+  }
+  if (supervisor_faulted()) {
+    modeClass = "alert";
+    modeText = "SAFE MODE - TASK FAULT";
   }
+  const char *toggleTarget = modeSnapshot == SHIELDED ? "normal" : "shielded";
 
-  server.send(200, "text/html", response);
+  int length = snprintf(response.body, response.bodyCapacity, STATUS_PAGE,
+                        modeClass, modeText, reading.level, ackText,
+                        toggleTarget, (unsigned long)newCommandId());
+  response.bodyLength = length > 0 ? length : 0;
 }
 
+void sendHtml(const HttpRequest &request, HttpResponse &response) {
+  renderStatusPage(response, "");
+}
 
-// --- FreeRTOS Application Tasks ---
-void webServerTask(void *pvParameters){
-  for(;;){
-    server.handleClient();
-    vTaskDelay(pdMS_TO_TICKS(10));
+// The deferred-poll token is the command ID with the requested target in bit 31
+uint32_t commandToken(uint32_t id, SystemMode target) {
+  return id | (target == SHIELDED ? ~COMMAND_ID_MAX : 0);
+}
+
+// Deferred completion of /toggle_mode: answers once eventResponseTask has logged
+// the command, so the acknowledgement rides on the original HTTP response.
+// A logged command with the same ID but another target answers 409 Conflict.
+bool ackModeCommand(uint32_t token, bool timedOut, HttpResponse &response) {
+  uint32_t id = token & COMMAND_ID_MAX;
+  SystemMode requested = (token & ~COMMAND_ID_MAX) ? SHIELDED : NORMAL;
+  SystemMode logged = requested;
+  CommandStatus status = commandLogFind(id, &logged);
+  if (status == CMD_UNKNOWN && !timedOut) return false;
+
+  const char *statusText = "pending";
+  if (status == CMD_APPLIED) statusText = "applied";
+  if (status == CMD_UNCHANGED) statusText = "unchanged";
+  if (status == CMD_UNKNOWN) response.status = 202;
+  if (status != CMD_UNKNOWN && logged != requested) {
+    statusText = "conflict";
+    response.status = 409;
   }
+
+  response.headersLength = snprintf(response.headers, response.headersCapacity,
+                                    "X-Command-Id: %lu\r\nX-Command-Status: %s\r\n",
+                                    (unsigned long)id, statusText);
+  char ackText[48];
+  snprintf(ackText, sizeof(ackText), "Command #%lu: %s", (unsigned long)id, statusText);
+  renderStatusPage(response, ackText);
+  return true;
 }
 
-void heartbeatTask(void *pvParameters) {
-  for (;;) {
-    digitalWrite(GREEN_STATUS_LED, HIGH);
-    vTaskDelay(pdMS_TO_TICKS(1000));
-    digitalWrite(GREEN_STATUS_LED, LOW);
-    vTaskDelay(pdMS_TO_TICKS(1000));
+// /toggle_mode?mode=shielded|normal&id=N sets an explicit mode. Both parameters are
+// required: a target resolved from the current mode would flip back on a retry, and a
+// request without a client ID cannot be deduplicated. The status page always links
+// with both, so a bare or malformed request gets a 400 with a fresh link.
+void toggleMode(const HttpRequest &request, HttpResponse &response) {
+  char value[16];
+  uint32_t id = 0;
+  if (httpQueryParam(request.query, "id", value, sizeof(value))) {
+    unsigned long parsed = strtoul(value, NULL, 10);
+    id = parsed <= COMMAND_ID_MAX ? (uint32_t)parsed : 0;
   }
+
+  bool haveMode = httpQueryParam(request.query, "mode", value, sizeof(value));
+  bool shielded = haveMode && strcasecmp(value, "shielded") == 0;
+  bool normal = haveMode && strcasecmp(value, "normal") == 0;
+  if (id == 0 || !(shielded || normal)) {
+    response.status = 400;
+    renderStatusPage(response, "Command needs mode=shielded|normal and an id of 1-2147483647.");
+    return;
+  }
+  SystemMode target = shielded ? SHIELDED : NORMAL;
+
+  // A retry of a command that already completed is answered from the log (409 if the
+  // ID was logged with the other target).
+  if (commandLogFind(id, NULL) != CMD_UNKNOWN) {
+    ackModeCommand(commandToken(id, target), true, response);
+    return;
+  }
+  if (!submitModeCommand(id, target)) {
+    response.status = 503;
+    renderStatusPage(response, "Command queue full, try again.");
+    return;
+  }
+
+  // No logging here: log_message() can block the select() loop. processCommandBatch
+  // logs every command once it has a result.
+  response.poll = ackModeCommand;
+  response.pollToken = commandToken(id, target);
+}
+
+static const HttpRoute routes[] = {
+  { "/", sendHtml },
+  { "/toggle_mode", toggleMode },
+};
+
+
+// --- FreeRTOS Application Tasks ---
+// Event-driven: blocks in select() until a client needs service, no fixed poll interval.
+void webServerTask(void *pvParameters){
+  httpServerRun();
+  vTaskDelete(NULL);  // Only reached if the server never started
 }
 
 void sensorMonitorTask(void *pvParameters) {
   for (;;) {
-    int sensorValue = analogRead(RAD_SENSOR_PIN);
-    xQueueOverwrite(sensorDataQueue, &sensorValue);
-    if (sensorValue > RADIATION_THRESHOLD) {
+    SensorReading reading;
+    reading.level = analogRead(RAD_SENSOR_PIN);
+    reading.alert = reading.level > RADIATION_THRESHOLD;
+    seqlock_publish(&sensorSnapshot, &reading);
+    if (reading.alert) {
       xSemaphoreGive(sensorAlertSemaphore);
     }
+    supervisor_checkin(&sensorLiveness);
     vTaskDelay(pdMS_TO_TICKS(17));
   }
 }
@@ -119,30 +302,119 @@ void sensorMonitorTask(void *pvParameters) {
 void buttonWatchTask(void *pvParameters) {
   // **BUG FIX 1:** Initialize last state to the current pin reading to prevent false trigger on boot.
   int lastButtonState = digitalRead(MODE_BUTTON_PIN);
+  uint32_t pendingId = 0;  // Last press's command until it shows up in the command log
+  TickType_t pendingSince = 0;
   for (;;) {
     int currentButtonState = digitalRead(MODE_BUTTON_PIN);
+    // HTTP traffic can evict the entry from the command log before it is seen here,
+    // so a press that never shows up stops blocking the button after a timeout.
+    if (pendingId != 0 && (commandLogFind(pendingId, NULL) != CMD_UNKNOWN ||
+                           xTaskGetTickCount() - pendingSince >= pdMS_TO_TICKS(BUTTON_PENDING_TIMEOUT_MS))) {
+      pendingId = 0;
+    }
     if (lastButtonState == HIGH && currentButtonState == LOW) {
       vTaskDelay(pdMS_TO_TICKS(50));
       currentButtonState = digitalRead(MODE_BUTTON_PIN);
       if (currentButtonState == LOW) {
-        log_message("Physical button pressed. Signaling mode change.");
-        xSemaphoreGive(modeChangeSemaphore);
+        // One press is one command with an explicit target. The target is only read
+        // from currentMode once the previous press has been applied (results are logged
+        // after the mode changes), so a press never resolves against a stale mode.
+        if (pendingId != 0) {
+          log_message("Physical button pressed while the previous press is pending. Ignored.");
+        } else {
+          SystemMode target = (currentMode == NORMAL) ? SHIELDED : NORMAL;
+          uint32_t id = newCommandId();
+          if (submitModeCommand(id, target)) {
+            pendingId = id;
+            pendingSince = xTaskGetTickCount();
+            log_message(target == SHIELDED ? "Physical button pressed. Requesting SHIELDED mode."
+                                           : "Physical button pressed. Requesting NORMAL mode.");
+          } else {
+            log_message("Physical button pressed but command queue is full.");
+          }
+        }
       }
     }
     lastButtonState = currentButtonState;
+    supervisor_checkin(&buttonLiveness);
     vTaskDelay(pdMS_TO_TICKS(20));
   }
 }
 
+// Drains every queued command in one pass. Each command gets its own result in the
+// command log, but the mode output is driven once per batch with the final state.
+void processCommandBatch() {
+  ModeCommand batch[COMMAND_QUEUE_DEPTH];
+  CommandStatus results[COMMAND_QUEUE_DEPTH];
+  int count = 0;
+  while (count < COMMAND_QUEUE_DEPTH && xQueueReceive(commandQueue, &batch[count], 0) == pdTRUE) {
+    count++;
+  }
+  if (count == 0) return;
+
+  SystemMode mode = currentMode;
+  int duplicates = 0;
+  for (int i = 0; i < count; i++) {
+    // A reused ID is skipped whatever its target; its ack reports the conflict
+    bool duplicate = commandLogFind(batch[i].id, NULL) != CMD_UNKNOWN;
+    for (int j = 0; j < i && !duplicate; j++) {
+      duplicate = batch[j].id == batch[i].id;
+    }
+    if (duplicate) {
+      results[i] = CMD_UNKNOWN;
+      duplicates++;
+      continue;
+    }
+    switch (batch[i].type) {
+      case CMD_SET_MODE: {
+        // Safe mode pins SHIELDED until reset; a NORMAL request is answered as unchanged
+        SystemMode target = supervisor_faulted() ? SHIELDED : batch[i].target;
+        results[i] = (target == mode) ? CMD_UNCHANGED : CMD_APPLIED;
+        mode = target;
+        break;
+      }
+    }
+  }
+
+  if (mode != currentMode) {
+    currentMode = mode;
+    if (currentMode == SHIELDED) {
+        log_message("Mode changed to SHIELDED.");
+        digitalWrite(RED_ALERT_LED, HIGH);
+    } else {
+        log_message("Mode changed to NORMAL.");
+        digitalWrite(RED_ALERT_LED, LOW);
+    }
+  }
+
+  // Publish results only after the mode is applied, so an ack never precedes it.
+  for (int i = 0; i < count; i++) {
+    if (results[i] != CMD_UNKNOWN) commandLogRecord(batch[i].id, batch[i].target, results[i]);
+  }
+  char message[64];
+  for (int i = 0; i < count; i++) {
+    snprintf(message, sizeof(message), "Command #%lu: set %s, %s.", (unsigned long)batch[i].id,
+             modeName(batch[i].target),
+             results[i] == CMD_APPLIED ? "applied" : results[i] == CMD_UNCHANGED ? "unchanged" : "duplicate");
+    log_message(message);
+  }
+  snprintf(message, sizeof(message), "Processed %d mode command(s), %d duplicate(s).", count, duplicates);
+  log_message(message);
+  httpServerWake();
+}
+
 void eventResponseTask(void *pvParameters) {
-  QueueSetHandle_t eventSet = xQueueCreateSet(1 + 1);
+  // One set slot per item that can be pending: counting semaphore + command queue.
+  QueueSetHandle_t eventSet = xQueueCreateSet(10 + COMMAND_QUEUE_DEPTH);
   xQueueAddToSet(sensorAlertSemaphore, eventSet);
-  xQueueAddToSet(modeChangeSemaphore, eventSet);
+  xQueueAddToSet(commandQueue, eventSet);
 
   for (;;) {
-    QueueSetMemberHandle_t activeSemaphore = xQueueSelectFromSet(eventSet, portMAX_DELAY);
+    supervisor_checkin(&eventLiveness);
+    // Bounded wait, so the task can check in while no event arrives (NULL on timeout)
+    QueueSetMemberHandle_t activeMember = xQueueSelectFromSet(eventSet, pdMS_TO_TICKS(EVENT_WAIT_MS));
 
-    if (activeSemaphore == sensorAlertSemaphore) {
+    if (activeMember == sensorAlertSemaphore) {
       if (xSemaphoreTake(sensorAlertSemaphore, 0) == pdTRUE) {
         log_message("CRITICAL: High radiation event received!");
         for (int i = 0; i < 5; i++) {
@@ -153,28 +425,38 @@ void eventResponseTask(void *pvParameters) {
         }
       }
     }
-    
-    if (activeSemaphore == modeChangeSemaphore) {
-      if (xSemaphoreTake(modeChangeSemaphore, 0) == pdTRUE) {
-        currentMode = (currentMode == NORMAL) ? SHIELDED : NORMAL;
-        if (currentMode == SHIELDED) {
-            log_message("Mode changed to SHIELDED.");
-            digitalWrite(RED_ALERT_LED, HIGH);
-        } else {
-            log_message("Mode changed to NORMAL.");
-            digitalWrite(RED_ALERT_LED, LOW);
-        }
-      }
+
+    // Commands that arrived during the alert blink are handled together here;
+    // later set notifications for already-drained items find the queue empty.
+    if (activeMember == commandQueue) {
+      processCommandBatch();
     }
+
+    // Safe mode: currentMode is only ever written by this task, so the latch is applied
+    // here (at least once per EVENT_WAIT_MS) rather than from the supervisor callback.
+    if (supervisor_faulted() && currentMode != SHIELDED) {
+      currentMode = SHIELDED;
+      log_message("Safe mode: mode forced to SHIELDED.");
+    }
+    supervisor_report_misses();  // Prints each missed check-in once, off the timer callback
   }
 }
 
+// --- Liveness Safe State ---
+// Called by the supervisor on every tick once a check-in is missed: drive the shielded
+// output directly, since the hung task may be eventResponseTask itself. It only touches
+// the pin; currentMode belongs to eventResponseTask, which forces SHIELDED itself.
+void enterSafeMode(const supervised_task_t *culprit, void *context) {
+  digitalWrite(RED_ALERT_LED, HIGH);
+}
+
 // --- Initializer Task ---
 void systemInitTask(void *pvParameters) {
-  logMutex = xSemaphoreCreateMutex();
+  // ButtonWatch (priority 3) polls every 20 ms; a longer wait for the log delays a press.
+  audited_mutex_init(&logMutex, "logMutex", 20000);
   sensorAlertSemaphore = xSemaphoreCreateCounting(10, 0);
-  modeChangeSemaphore = xSemaphoreCreateBinary();
-  sensorDataQueue = xQueueCreate(1, sizeof(int));
+  commandQueue = xQueueCreate(COMMAND_QUEUE_DEPTH, sizeof(ModeCommand));
+  nextCommandId = esp_random();  // Fresh IDs after a reboot, so stale retries are not mistaken as seen
   
   log_message("System boot. Initializing...");
 
@@ -188,28 +470,70 @@ void systemInitTask(void *pvParameters) {
   Serial.print("IP Address: ");
   Serial.println(WiFi.localIP());
 
-  server.on("/", []() { sendHtml(); });
-  server.on("/toggle_mode", []() {
-      log_message("Remote command received. Signaling mode change.");
-      xSemaphoreGive(modeChangeSemaphore);
-      sendHtml();
-  });
-  server.begin();
-  log_message("HTTP command interface online.");
+  bool httpOnline = httpServerBegin(80, routes, sizeof(routes) / sizeof(routes[0]));
+  if (httpOnline) {
+    log_message("HTTP command interface online.");
+  } else {
+    log_message("ERROR: HTTP command interface failed to start.");
+  }
 
   log_message("Starting application tasks...");
-  xTaskCreatePinnedToCore(heartbeatTask, "Heartbeat", 1024, NULL, 0, NULL, 0);
+  supervisor_watch(&sensorLiveness, "SensorMonitor", SENSOR_CHECKIN_DEADLINE_MS);
+  supervisor_watch(&buttonLiveness, "ButtonWatch", BUTTON_CHECKIN_DEADLINE_MS);
+  supervisor_watch(&eventLiveness, "EventResponse", EVENT_CHECKIN_DEADLINE_MS);
   xTaskCreatePinnedToCore(sensorMonitorTask, "SensorMonitor", 2048, NULL, 2, NULL, 0);
   xTaskCreatePinnedToCore(buttonWatchTask, "ButtonWatch", 2048, NULL, 3, NULL, 0);
   // **BUG FIX 2:** Increased stack size for the event response task to prevent stack overflow.
   xTaskCreatePinnedToCore(eventResponseTask, "EventResponse", 8192, NULL, 2, NULL, 1);
-  xTaskCreatePinnedToCore(webServerTask, "WebServer", 4096, NULL, 1, NULL, 1);
+  if (httpOnline) {
+    xTaskCreatePinnedToCore(webServerTask, "WebServer", 4096, NULL, 1, NULL, 1);
+  }
+  audited_mutex_start_reporter(30000, 1, &logMutex);  // Blocking-time audit every 30 s
+
+  // Replaces the heartbeat task: blinks the green LED, feeds the task watchdog and
+  // enters safe mode on a missed check-in. The event-driven web server is not watched.
+  supervisor_config_t supervisorConfig = {};
+  supervisorConfig.period_ms = SUPERVISOR_PERIOD_MS;
+  supervisorConfig.heartbeat_gpio = GREEN_STATUS_LED;
+  supervisorConfig.heartbeat_half_period_ms = HEARTBEAT_HALF_PERIOD_MS;
+  supervisorConfig.safe_state = enterSafeMode;
+  if (!supervisor_start(&supervisorConfig)) {
+    log_message("ERROR: liveness supervisor failed to start.");
+  }
 
   log_message("Initialization complete. Deleting init task.");
   vTaskDelete(NULL);
 }
 
 
+#if WCET_BENCHMARK
+// --- WCET Benchmark ---
+// sendHtml is timed rendering into a connection-sized body buffer, as the server would call it.
+static char benchBody[HTTP_BODY_BUFFER_SIZE];
+static HttpResponse benchResponse;
+
+void statusPageBenchSetup(void *context) {
+  HttpResponse &response = *(HttpResponse *)context;
+  memset(&response, 0, sizeof(response));
+  response.status = 200;
+  response.body = benchBody;
+  response.bodyCapacity = sizeof(benchBody);
+}
+
+void statusPageBenchBody(void *context) {
+  static const HttpRequest request = { "/", "" };
+  sendHtml(request, *(HttpResponse *)context);
+}
+
+void runWcetBenchmarks() {
+  static const wcet_case_t cases[] = {
+    { "sendHtml", statusPageBenchBody, statusPageBenchSetup, &benchResponse, STATUS_PAGE_BUDGET_US },
+  };
+  wcet_run(cases, sizeof(cases) / sizeof(cases[0]), WCET_DEFAULT_ITERATIONS);
+}
+#endif
+
+
 // --- Main Arduino Setup and Loop ---
 void setup() {
   Serial.begin(115200);
@@ -218,6 +542,12 @@ void setup() {
   pinMode(RED_ALERT_LED, OUTPUT);
   pinMode(RAD_SENSOR_PIN, INPUT);
   pinMode(MODE_BUTTON_PIN, INPUT_PULLUP);
+
+#if WCET_BENCHMARK
+  // Benchmark mode: no WiFi and no mission tasks, so nothing disturbs the measurements
+  runWcetBenchmarks();
+  return;
+#endif
   
   xTaskCreatePinnedToCore(systemInitTask, "SystemInit", 8192, NULL, 2, NULL, 1);
 }
@@ -0,0 +1,472 @@
+#include "http_server.h"
+
+#include <Arduino.h>
+#include <errno.h>
+#include <string.h>
+#include <strings.h>
+#include "lwip/sockets.h"
+
+// --- Per-Connection State Machine ---
+// FREE -> READING -> [DEFERRED ->] WRITING -> READING (keep-alive) ... -> FREE
+enum ConnState { CONN_FREE, CONN_READING, CONN_DEFERRED, CONN_WRITING };
+
+struct HttpConnection {
+  int fd;
+  ConnState state;
+  bool keepAlive;
+  bool headOnly;
+  uint16_t requestsServed;
+  uint32_t deadlineMs;      // Request/idle/write deadline, refreshed on progress
+  size_t rxLength;
+  size_t headLength;
+  size_t bodyLength;
+  size_t txOffset;          // Bytes of head+body already sent
+  size_t extraLength;
+  HttpDeferredPoll poll;
+  uint32_t pollToken;
+  char rx[HTTP_RX_BUFFER_SIZE];
+  char head[HTTP_HEAD_BUFFER_SIZE];
+  char extra[HTTP_EXTRA_HEADERS_SIZE];
+  char body[HTTP_BODY_BUFFER_SIZE];
+};
+
+static HttpConnection connections[HTTP_MAX_CONNECTIONS];
+static int listenFd = -1;
+static int wakeFd = -1;   // Loopback UDP socket other tasks poke to interrupt select()
+static struct sockaddr_in wakeAddr;
+static const HttpRoute *routeTable = NULL;
+static size_t routeTableSize = 0;
+
+// --- Socket Helpers ---
+static bool deadlinePassed(uint32_t now, uint32_t deadline) {
+  return (int32_t)(now - deadline) >= 0;
+}
+
+static void setNonBlocking(int fd) {
+  int flags = fcntl(fd, F_GETFL, 0);
+  fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+static void closeConnection(HttpConnection *c) {
+  close(c->fd);
+  c->fd = -1;
+  c->state = CONN_FREE;
+}
+
+static void startReading(HttpConnection *c, uint32_t now) {
+  c->state = CONN_READING;
+  c->deadlineMs = now + (c->rxLength > 0 ? HTTP_REQUEST_TIMEOUT_MS : HTTP_IDLE_TIMEOUT_MS);
+}
+
+static int countFreeSlots() {
+  int count = 0;
+  for (int i = 0; i < HTTP_MAX_CONNECTIONS; i++) {
+    if (connections[i].state == CONN_FREE) count++;
+  }
+  return count;
+}
+
+static const char *statusText(int status) {
+  switch (status) {
+    case 200: return "OK";
+    case 202: return "Accepted";
+    case 400: return "Bad Request";
+    case 404: return "Not Found";
+    case 405: return "Method Not Allowed";
+    case 409: return "Conflict";
+    case 431: return "Request Header Fields Too Large";
+    case 500: return "Internal Server Error";
+    case 503: return "Service Unavailable";
+  }
+  // Unlisted codes get their class's generic phrase rather than passing as a 500
+  switch (status / 100) {
+    case 2:  return "Success";
+    case 3:  return "Redirection";
+    case 4:  return "Client Error";
+    default: return "Server Error";
+  }
+}
+
+// --- Request Handling ---
+static int findHeaderEnd(const char *buf, size_t len) {
+  for (size_t i = 3; i < len; i++) {
+    if (buf[i - 3] == '\r' && buf[i - 2] == '\n' && buf[i - 1] == '\r' && buf[i] == '\n') {
+      return (int)(i + 1);
+    }
+  }
+  return -1;
+}
+
+// Returns the value of a header (case-insensitive name) inside a NUL-terminated header block.
+static const char *findHeader(const char *headers, const char *name, size_t *valueLength) {
+  size_t nameLength = strlen(name);
+  for (const char *line = strstr(headers, "\r\n"); line != NULL; line = strstr(line, "\r\n")) {
+    line += 2;
+    if (strncasecmp(line, name, nameLength) == 0 && line[nameLength] == ':') {
+      const char *value = line + nameLength + 1;
+      while (*value == ' ') value++;
+      const char *end = strstr(value, "\r\n");
+      *valueLength = end ? (size_t)(end - value) : strlen(value);
+      return value;
+    }
+  }
+  return NULL;
+}
+
+static void buildResponse(HttpConnection *c, int status, const char *contentType) {
+  c->headLength = snprintf(c->head, sizeof(c->head),
+                           "HTTP/1.1 %d %s\r\n"
+                           "Content-Type: %s\r\n"
+                           "Content-Length: %u\r\n"
+                           "Connection: %s\r\n"
+                           "%.*s\r\n",
+                           status, statusText(status), contentType,
+                           (unsigned)c->bodyLength, c->keepAlive ? "keep-alive" : "close",
+                           (int)c->extraLength, c->extra);
+  if (c->headOnly) c->bodyLength = 0;
+  c->txOffset = 0;
+  c->state = CONN_WRITING;
+  c->deadlineMs = millis() + HTTP_IDLE_TIMEOUT_MS;
+}
+
+static void sendError(HttpConnection *c, int status) {
+  c->keepAlive = false;
+  c->extraLength = 0;
+  c->bodyLength = snprintf(c->body, sizeof(c->body), "%d %s\n", status, statusText(status));
+  buildResponse(c, status, "text/plain");
+}
+
+static HttpResponse newResponse(HttpConnection *c) {
+  HttpResponse res = { 200, "text/html", c->body, sizeof(c->body), 0,
+                       c->extra, sizeof(c->extra), 0, NULL, 0 };
+  return res;
+}
+
+static void finishResponse(HttpConnection *c, const HttpResponse &res) {
+  c->bodyLength = res.bodyLength < sizeof(c->body) ? res.bodyLength : sizeof(c->body);
+  c->extraLength = res.headersLength < sizeof(c->extra) ? res.headersLength : sizeof(c->extra);
+  buildResponse(c, res.status, res.contentType);
+}
+
+// Parses one complete request from the front of rx and prepares its response.
+static void processRequest(HttpConnection *c, int headerEnd) {
+  char *request = c->rx;
+  request[headerEnd - 2] = '\0';  // Terminate the header block at the blank line
+
+  char *method = request;
+  char *target = strchr(method, ' ');
+  char *version = target ? strchr(target + 1, ' ') : NULL;
+  c->keepAlive = false;
+  c->headOnly = false;
+  if (target == NULL || version == NULL) {
+    sendError(c, 400);
+    return;
+  }
+  *target++ = '\0';
+  *version++ = '\0';
+  const char *headers = strstr(version, "\r\n");
+  if (headers == NULL) headers = "";
+
+  // HTTP/1.1 defaults to keep-alive, HTTP/1.0 must ask for it.
+  bool http11 = strncmp(version, "HTTP/1.1", 8) == 0;
+  size_t connLength = 0;
+  const char *conn = findHeader(headers, "Connection", &connLength);
+  if (conn && connLength == 5 && strncasecmp(conn, "close", 5) == 0) {
+    c->keepAlive = false;
+  } else if (conn && connLength == 10 && strncasecmp(conn, "keep-alive", 10) == 0) {
+    c->keepAlive = true;
+  } else {
+    c->keepAlive = http11;
+  }
+  c->requestsServed++;
+  if (c->requestsServed >= HTTP_MAX_KEEPALIVE_REQUESTS) c->keepAlive = false;
+  // Pool saturated: close after this response so clients waiting in the backlog get a slot.
+  if (countFreeSlots() == 0) c->keepAlive = false;
+
+  c->headOnly = strcmp(method, "HEAD") == 0;
+  if (!c->headOnly && strcmp(method, "GET") != 0) {
+    sendError(c, 405);
+    return;
+  }
+
+  char *query = strchr(target, '?');
+  if (query) *query++ = '\0';
+
+  for (size_t i = 0; i < routeTableSize; i++) {
+    if (strcmp(routeTable[i].path, target) == 0) {
+      HttpRequest req = { target, query ? query : "" };
+      HttpResponse res = newResponse(c);
+      routeTable[i].handler(req, res);
+      if (res.poll != NULL) {
+        c->poll = res.poll;
+        c->pollToken = res.pollToken;
+        c->state = CONN_DEFERRED;
+        c->deadlineMs = millis() + HTTP_DEFER_TIMEOUT_MS;
+        return;
+      }
+      finishResponse(c, res);
+      return;
+    }
+  }
+  sendError(c, 404);
+}
+
+// Drops the request just answered from rx, keeping any pipelined bytes behind it.
+static void consumeRequest(HttpConnection *c, int headerEnd) {
+  c->rxLength -= headerEnd;
+  memmove(c->rx, c->rx + headerEnd, c->rxLength);
+}
+
+// Sends as much of the pending response as the socket accepts. Returns true once
+// the response is complete, after moving the connection back to READING or FREE.
+static bool flushResponse(HttpConnection *c, uint32_t now) {
+  size_t total = c->headLength + c->bodyLength;
+  while (c->txOffset < total) {
+    const char *chunk;
+    size_t chunkLength;
+    if (c->txOffset < c->headLength) {
+      chunk = c->head + c->txOffset;
+      chunkLength = c->headLength - c->txOffset;
+    } else {
+      chunk = c->body + (c->txOffset - c->headLength);
+      chunkLength = total - c->txOffset;
+    }
+    ssize_t n = send(c->fd, chunk, chunkLength, 0);
+    if (n < 0) {
+      if (errno != EAGAIN && errno != EWOULDBLOCK) closeConnection(c);
+      return false;
+    }
+    c->txOffset += n;
+    c->deadlineMs = now + HTTP_IDLE_TIMEOUT_MS;
+  }
+
+  if (c->keepAlive) {
+    startReading(c, now);
+  } else {
+    closeConnection(c);
+  }
+  return true;
+}
+
+// Alternates parsing and sending until the connection needs more input,
+// would block on send, or is closed. Handles pipelined requests in order.
+static void serviceConnection(HttpConnection *c, uint32_t now) {
+  for (;;) {
+    if (c->state == CONN_READING) {
+      int headerEnd = findHeaderEnd(c->rx, c->rxLength);
+      if (headerEnd > 0) {
+        processRequest(c, headerEnd);
+        consumeRequest(c, headerEnd);
+      } else if (c->rxLength == sizeof(c->rx)) {
+        c->rxLength = 0;
+        sendError(c, 431);
+      } else {
+        return;
+      }
+    }
+    if (c->state != CONN_WRITING || !flushResponse(c, now) || c->state != CONN_READING) {
+      return;
+    }
+  }
+}
+
+// Gives a deferred handler the chance to answer; forces an answer at the deadline.
+static void pollDeferred(HttpConnection *c, uint32_t now) {
+  HttpResponse res = newResponse(c);
+  if (!c->poll(c->pollToken, deadlinePassed(now, c->deadlineMs), res)) return;
+  finishResponse(c, res);
+  serviceConnection(c, now);
+}
+
+static void handleReadable(HttpConnection *c, uint32_t now) {
+  ssize_t n = recv(c->fd, c->rx + c->rxLength, sizeof(c->rx) - c->rxLength, 0);
+  if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+    closeConnection(c);
+    return;
+  }
+  if (n < 0) return;
+  if (c->rxLength == 0) c->deadlineMs = now + HTTP_REQUEST_TIMEOUT_MS;
+  c->rxLength += n;
+  serviceConnection(c, now);
+}
+
+// --- Connection Pool ---
+// Idle keep-alive connection that may be closed to make room for a new client.
+static bool isEvictable(const HttpConnection *c, uint32_t now) {
+  uint32_t idleSinceMs = c->deadlineMs - HTTP_IDLE_TIMEOUT_MS;
+  return c->state == CONN_READING && c->rxLength == 0 && c->requestsServed > 0 &&
+         (int32_t)(now - idleSinceMs) >= HTTP_EVICT_IDLE_MS;
+}
+
+static bool poolHasRoom(uint32_t now) {
+  for (int i = 0; i < HTTP_MAX_CONNECTIONS; i++) {
+    if (connections[i].state == CONN_FREE || isEvictable(&connections[i], now)) return true;
+  }
+  return false;
+}
+
+static HttpConnection *allocateConnection(uint32_t now) {
+  for (int i = 0; i < HTTP_MAX_CONNECTIONS; i++) {
+    if (connections[i].state == CONN_FREE) return &connections[i];
+  }
+  // Pool full: recycle the keep-alive connection that has been idle the longest.
+  HttpConnection *victim = NULL;
+  for (int i = 0; i < HTTP_MAX_CONNECTIONS; i++) {
+    HttpConnection *c = &connections[i];
+    if (isEvictable(c, now) && (victim == NULL || (int32_t)(c->deadlineMs - victim->deadlineMs) < 0)) {
+      victim = c;
+    }
+  }
+  closeConnection(victim);
+  return victim;
+}
+
+static void acceptConnections(uint32_t now) {
+  while (poolHasRoom(now)) {
+    int fd = accept(listenFd, NULL, NULL);
+    if (fd < 0) return;
+    setNonBlocking(fd);
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    HttpConnection *c = allocateConnection(now);
+    c->fd = fd;
+    c->rxLength = 0;
+    c->requestsServed = 0;
+    startReading(c, now);
+  }
+}
+
+// --- Public API ---
+bool httpServerBegin(uint16_t port, const HttpRoute *routes, size_t routeCount) {
+  routeTable = routes;
+  routeTableSize = routeCount;
+  for (int i = 0; i < HTTP_MAX_CONNECTIONS; i++) {
+    connections[i].fd = -1;
+    connections[i].state = CONN_FREE;
+  }
+
+  listenFd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  if (listenFd < 0) return false;
+  int one = 1;
+  setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  if (bind(listenFd, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+      listen(listenFd, HTTP_LISTEN_BACKLOG) < 0) {
+    close(listenFd);
+    listenFd = -1;
+    return false;
+  }
+  setNonBlocking(listenFd);
+
+  wakeFd = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+  memset(&wakeAddr, 0, sizeof(wakeAddr));
+  wakeAddr.sin_family = AF_INET;
+  wakeAddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t wakeAddrLength = sizeof(wakeAddr);
+  if (wakeFd < 0 || bind(wakeFd, (struct sockaddr *)&wakeAddr, sizeof(wakeAddr)) < 0 ||
+      getsockname(wakeFd, (struct sockaddr *)&wakeAddr, &wakeAddrLength) < 0) {
+    if (wakeFd >= 0) close(wakeFd);
+    wakeFd = -1;
+    close(listenFd);
+    listenFd = -1;
+    return false;
+  }
+  setNonBlocking(wakeFd);
+  return true;
+}
+
+void httpServerWake() {
+  if (wakeFd < 0) return;
+  char poke = 0;
+  sendto(wakeFd, &poke, 1, 0, (struct sockaddr *)&wakeAddr, sizeof(wakeAddr));
+}
+
+bool httpQueryParam(const char *query, const char *name, char *value, size_t valueCapacity) {
+  size_t nameLength = strlen(name);
+  for (const char *p = query; p != NULL && *p != '\0'; p = strchr(p, '&')) {
+    if (*p == '&') p++;
+    if (strncmp(p, name, nameLength) == 0 && p[nameLength] == '=') {
+      const char *start = p + nameLength + 1;
+      size_t length = strcspn(start, "&");
+      if (length >= valueCapacity) length = valueCapacity - 1;
+      memcpy(value, start, length);
+      value[length] = '\0';
+      return true;
+    }
+  }
+  return false;
+}
+
+void httpServerRun() {
+  // Without both sockets there is nothing to select() on; FD_SET(-1) is undefined.
+  if (listenFd < 0 || wakeFd < 0) return;
+  for (;;) {
+    fd_set readSet, writeSet;
+    FD_ZERO(&readSet);
+    FD_ZERO(&writeSet);
+    int maxFd = -1;
+    uint32_t now = millis();
+    uint32_t nextDeadline = now + HTTP_IDLE_TIMEOUT_MS;
+
+    // Only watch the listener while a pool slot can take the client;
+    // otherwise it stays in the backlog instead of spinning select().
+    FD_SET(wakeFd, &readSet);
+    maxFd = wakeFd;
+    if (poolHasRoom(now)) {
+      FD_SET(listenFd, &readSet);
+      if (listenFd > maxFd) maxFd = listenFd;
+    } else {
+      nextDeadline = now + HTTP_EVICT_IDLE_MS;
+    }
+    for (int i = 0; i < HTTP_MAX_CONNECTIONS; i++) {
+      HttpConnection *c = &connections[i];
+      if (c->state == CONN_FREE) continue;
+      if ((int32_t)(c->deadlineMs - nextDeadline) < 0) nextDeadline = c->deadlineMs;
+      if (c->state == CONN_DEFERRED) continue;  // Waiting on the application, not the socket
+      FD_SET(c->fd, c->state == CONN_READING ? &readSet : &writeSet);
+      if (c->fd > maxFd) maxFd = c->fd;
+    }
+
+    // Block until there is socket activity or the nearest connection deadline.
+    uint32_t waitMs = deadlinePassed(now, nextDeadline) ? 0 : nextDeadline - now;
+    struct timeval timeout;
+    timeout.tv_sec = waitMs / 1000;
+    timeout.tv_usec = (waitMs % 1000) * 1000;
+    int ready = select(maxFd + 1, &readSet, &writeSet, NULL, &timeout);
+    if (ready < 0) {
+      // A persistent error would otherwise spin this loop at full speed.
+      Serial.printf("HTTP: select() failed, errno %d\n", errno);
+      delay(HTTP_SELECT_RETRY_MS);
+      continue;
+    }
+
+    now = millis();
+    if (FD_ISSET(wakeFd, &readSet)) {
+      char drain[16];
+      while (recv(wakeFd, drain, sizeof(drain), 0) > 0) {
+      }
+    }
+    for (int i = 0; i < HTTP_MAX_CONNECTIONS; i++) {
+      HttpConnection *c = &connections[i];
+      if (c->state == CONN_READING && FD_ISSET(c->fd, &readSet)) {
+        handleReadable(c, now);
+      } else if (c->state == CONN_WRITING && FD_ISSET(c->fd, &writeSet)) {
+        serviceConnection(c, now);
+      } else if (c->state == CONN_DEFERRED) {
+        pollDeferred(c, now);
+      }
+      if (c->state != CONN_FREE && deadlinePassed(now, c->deadlineMs)) {
+        closeConnection(c);
+      }
+    }
+    if (FD_ISSET(listenFd, &readSet)) {
+      acceptConnections(now);
+    }
+  }
+}
@@ -0,0 +1,65 @@
+// Event-loop HTTP server built directly on lwIP sockets.
+// A single task multiplexes every client with select(), so one slow
+// client can no longer stall the others the way WebServer::handleClient() did.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// --- Server Limits ---
+#define HTTP_MAX_CONNECTIONS 6          // Bounded connection pool (lwIP has ~10 sockets total)
+#define HTTP_LISTEN_BACKLOG 8           // Clients queued by the stack while the pool is full
+#define HTTP_RX_BUFFER_SIZE 512         // Request line + headers; bodies are not supported
+#define HTTP_HEAD_BUFFER_SIZE 256       // Status line + response headers
+#define HTTP_BODY_BUFFER_SIZE 2048      // Rendered page
+#define HTTP_REQUEST_TIMEOUT_MS 2000    // Max time to receive a full request once it has started
+#define HTTP_IDLE_TIMEOUT_MS 5000       // Keep-alive idle time, also bounds stalled writes
+#define HTTP_MAX_KEEPALIVE_REQUESTS 100 // Requests served before a keep-alive connection is recycled
+#define HTTP_EVICT_IDLE_MS 250          // Idle keep-alive connections older than this yield to new clients
+#define HTTP_EXTRA_HEADERS_SIZE 96      // Handler-supplied response headers
+#define HTTP_DEFER_TIMEOUT_MS 1500      // Longest a deferred response waits before it must be answered
+#define HTTP_SELECT_RETRY_MS 100        // Back-off after a select() error
+
+struct HttpRequest {
+  const char *path;   // NUL-terminated, without the query string
+  const char *query;  // NUL-terminated, empty if absent
+};
+
+struct HttpResponse;
+
+// Completes a deferred response. Called on every server wake-up until it returns
+// true; when timedOut is set it must fill in a response and return true.
+typedef bool (*HttpDeferredPoll)(uint32_t token, bool timedOut, HttpResponse &response);
+
+struct HttpResponse {
+  int status;               // Defaults to 200
+  const char *contentType;  // Defaults to "text/html"
+  char *body;               // Handler writes the body here...
+  size_t bodyCapacity;
+  size_t bodyLength;        // ...and reports its length here
+  char *headers;            // Optional extra "Name: value\r\n" lines
+  size_t headersCapacity;
+  size_t headersLength;
+  HttpDeferredPoll poll;    // Set to defer the response without blocking the event loop
+  uint32_t pollToken;       // Passed back to poll, e.g. a command ID
+};
+
+typedef void (*HttpHandler)(const HttpRequest &request, HttpResponse &response);
+
+struct HttpRoute {
+  const char *path;
+  HttpHandler handler;
+};
+
+// Opens the listening socket. Routes must stay valid for the server's lifetime.
+bool httpServerBegin(uint16_t port, const HttpRoute *routes, size_t routeCount);
+
+// Runs the event loop forever; call it from the task that owns the server.
+// Returns at once if httpServerBegin() did not succeed.
+void httpServerRun();
+
+// Wakes the event loop so deferred responses are polled. Safe from any task.
+void httpServerWake();
+
+// Copies the value of name from a query string ("a=1&b=2"). Returns false if absent.
+bool httpQueryParam(const char *query, const char *name, char *value, size_t valueCapacity);
@@ -0,0 +1,69 @@
+/***********************************************************************
+ * Seqlock Snapshot
+ * Publishes a multi-field record from exactly one writer to any number
+ * of readers (tasks or ISRs, on either core) without a mutex and without
+ * torn reads:
+ *   - The writer bumps the sequence to odd, copies the record, then
+ *     bumps it back to even.
+ *   - A reader copies the record and retries if the sequence was odd or
+ *     changed while it was copying.
+ * The writer masks interrupts on its own core for the few stores of the
+ * update, so a reader can never preempt a half-finished write and spin
+ * forever. Readers on the other core spin for at most that window.
+ ***********************************************************************/
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <stdint.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    volatile uint32_t sequence;   // Even: stable, odd: write in progress
+} seqlock_t;
+
+/* A snapshot is the lock plus the record it protects. */
+#define SEQLOCK_SNAPSHOT(type) struct { seqlock_t lock; type value; }
+
+/* Writer side: copies *src into the snapshot. Only one task may publish. */
+#define seqlock_publish(snapshot, src) \
+    seqlock_store(&(snapshot)->lock, &(snapshot)->value, (src), sizeof((snapshot)->value))
+
+/* Reader side: copies a consistent version of the snapshot into *dst. */
+#define seqlock_read(snapshot, dst) \
+    seqlock_load(&(snapshot)->lock, (dst), &(snapshot)->value, sizeof((snapshot)->value))
+
+static inline void seqlock_store(seqlock_t *lock, void *dst, const void *src, size_t size)
+{
+    UBaseType_t saved = portSET_INTERRUPT_MASK_FROM_ISR();
+    uint32_t sequence = lock->sequence;
+
+    __atomic_store_n(&lock->sequence, sequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);   // Odd sequence visible before any data
+    memcpy(dst, src, size);
+    __atomic_store_n(&lock->sequence, sequence + 2, __ATOMIC_RELEASE);
+
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(saved);
+}
+
+static inline void seqlock_load(const seqlock_t *lock, void *dst, const void *src, size_t size)
+{
+    uint32_t begin, end;
+
+    do {
+        begin = __atomic_load_n(&lock->sequence, __ATOMIC_ACQUIRE);
+        memcpy(dst, src, size);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);   // Data reads complete before re-check
+        end = __atomic_load_n(&lock->sequence, __ATOMIC_RELAXED);
+    } while ((begin & 1u) != 0 || begin != end);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SEQLOCK_H */
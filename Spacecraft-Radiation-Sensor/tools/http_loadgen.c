@@ -0,0 +1,239 @@
+/* --------------------------------------------------------------
+   HTTP load generator for the radiation monitor web interface.
+   Runs on the host (Linux/macOS), not on the ESP32.
+
+   Build:  cc -O2 -pthread -o http_loadgen http_loadgen.c
+   Usage:  ./http_loadgen <host> [port] [seconds] [path] [--close]
+           e.g. ./http_loadgen 127.0.0.1 9080 10 /
+
+   Each concurrency level (1, 10, 50 clients) runs for the given number
+   of seconds. Clients use keep-alive and reconnect when the server
+   recycles their connection; --close opens a new connection per request.
+   Reports requests/sec and p50/p99/max latency per level.
+
+   With the Wokwi VS Code extension, forward the board's port 80 with
+   [[net.forward]] from = "localhost:9080" to = "target:80" in wokwi.toml.
+---------------------------------------------------------------*/
+#define _POSIX_C_SOURCE 200809L
+#include <errno.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_CLIENTS 50
+#define MAX_SAMPLES_PER_CLIENT 200000
+#define RESPONSE_BUFFER_SIZE 8192
+
+static const int CONCURRENCY_LEVELS[] = { 1, 10, 50 };
+
+// Shared configuration
+static struct addrinfo *server_addr;
+static const char *request_path = "/";
+static const char *host_header = "localhost";
+static int keep_alive = 1;
+static volatile int stop_flag = 0;
+
+typedef struct {
+    pthread_t thread;
+    double *latencies_ms;   // One entry per completed request
+    size_t completed;
+    size_t errors;
+    size_t reconnects;
+} Client;
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+static int open_connection(void) {
+    int fd = socket(server_addr->ai_family, SOCK_STREAM, IPPROTO_TCP);
+    if (fd < 0) return -1;
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    struct timeval tv = { 5, 0 };  // Never hang forever on a dead server
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    if (connect(fd, server_addr->ai_addr, server_addr->ai_addrlen) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static int send_all(int fd, const char *buf, size_t len) {
+    while (len > 0) {
+        ssize_t n = send(fd, buf, len, 0);
+        if (n <= 0) return -1;
+        buf += n;
+        len -= n;
+    }
+    return 0;
+}
+
+// Reads exactly one response. Returns 0 on success, sets *server_closes if the
+// server announced "Connection: close".
+static int read_response(int fd, int *server_closes) {
+    char buf[RESPONSE_BUFFER_SIZE];
+    size_t have = 0;
+    char *header_end = NULL;
+
+    while (header_end == NULL) {
+        if (have == sizeof(buf) - 1) return -1;
+        ssize_t n = recv(fd, buf + have, sizeof(buf) - 1 - have, 0);
+        if (n <= 0) return -1;
+        have += n;
+        buf[have] = '\0';
+        header_end = strstr(buf, "\r\n\r\n");
+    }
+    if (strncmp(buf, "HTTP/1.", 7) != 0 || buf[9] != '2') return -1;
+
+    long content_length = -1;
+    *server_closes = 0;
+    for (char *line = strstr(buf, "\r\n"); line && line < header_end; line = strstr(line + 2, "\r\n")) {
+        if (strncasecmp(line + 2, "Content-Length:", 15) == 0) content_length = strtol(line + 17, NULL, 10);
+        if (strncasecmp(line + 2, "Connection: close", 17) == 0) *server_closes = 1;
+    }
+    if (content_length < 0) return -1;
+
+    size_t body_have = have - (size_t)(header_end + 4 - buf);
+    while ((long)body_have < content_length) {
+        ssize_t n = recv(fd, buf, sizeof(buf), 0);
+        if (n <= 0) return -1;
+        body_have += n;
+    }
+    return 0;
+}
+
+static void *client_main(void *arg) {
+    Client *client = (Client *)arg;
+    char request[256];
+    int len = snprintf(request, sizeof(request),
+                       "GET %s HTTP/1.1\r\nHost: %s\r\nConnection: %s\r\n\r\n",
+                       request_path, host_header, keep_alive ? "keep-alive" : "close");
+    int fd = -1;
+
+    while (!stop_flag) {
+        if (fd < 0) {
+            fd = open_connection();
+            if (fd < 0) {
+                client->errors++;
+                struct timespec backoff = { 0, 10 * 1000 * 1000 };
+                nanosleep(&backoff, NULL);
+                continue;
+            }
+            client->reconnects++;
+        }
+
+        double start = now_ms();
+        int server_closes = 0;
+        if (send_all(fd, request, len) < 0 || read_response(fd, &server_closes) < 0) {
+            // A recycled keep-alive connection is expected; retry on a fresh one.
+            close(fd);
+            fd = -1;
+            client->errors++;
+            continue;
+        }
+        if (client->completed < MAX_SAMPLES_PER_CLIENT) {
+            client->latencies_ms[client->completed] = now_ms() - start;
+        }
+        client->completed++;
+
+        if (!keep_alive || server_closes) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    if (fd >= 0) close(fd);
+    return NULL;
+}
+
+static int compare_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static void run_level(Client *clients, int concurrency, int seconds) {
+    stop_flag = 0;
+    for (int i = 0; i < concurrency; i++) {
+        clients[i].completed = clients[i].errors = clients[i].reconnects = 0;
+        pthread_create(&clients[i].thread, NULL, client_main, &clients[i]);
+    }
+    double start = now_ms();
+    sleep(seconds);
+    stop_flag = 1;
+    for (int i = 0; i < concurrency; i++) pthread_join(clients[i].thread, NULL);
+    double elapsed_s = (now_ms() - start) / 1000.0;
+
+    size_t total = 0, sampled = 0, errors = 0, connects = 0;
+    for (int i = 0; i < concurrency; i++) {
+        total += clients[i].completed;
+        errors += clients[i].errors;
+        connects += clients[i].reconnects;
+        sampled += clients[i].completed < MAX_SAMPLES_PER_CLIENT ? clients[i].completed : MAX_SAMPLES_PER_CLIENT;
+    }
+    double *all = malloc((sampled ? sampled : 1) * sizeof(double));
+    size_t k = 0;
+    for (int i = 0; i < concurrency; i++) {
+        size_t n = clients[i].completed < MAX_SAMPLES_PER_CLIENT ? clients[i].completed : MAX_SAMPLES_PER_CLIENT;
+        memcpy(all + k, clients[i].latencies_ms, n * sizeof(double));
+        k += n;
+    }
+    qsort(all, sampled, sizeof(double), compare_double);
+
+    double p50 = sampled ? all[(size_t)(sampled * 0.50)] : 0;
+    double p99 = sampled ? all[(size_t)(sampled * 0.99) < sampled ? (size_t)(sampled * 0.99) : sampled - 1] : 0;
+    double max = sampled ? all[sampled - 1] : 0;
+    printf("%8d %10zu %10.1f %9.2f %9.2f %9.2f %8zu %8zu\n",
+           concurrency, total, total / elapsed_s, p50, p99, max, errors, connects);
+    free(all);
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <host> [port] [seconds] [path] [--close]\n", argv[0]);
+        return 1;
+    }
+    const char *host = argv[1];
+    const char *port = argc > 2 ? argv[2] : "80";
+    int seconds = argc > 3 ? atoi(argv[3]) : 10;
+    if (argc > 4) request_path = argv[4];
+    if (argc > 5 && strcmp(argv[5], "--close") == 0) keep_alive = 0;
+    host_header = host;
+    signal(SIGPIPE, SIG_IGN);
+
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(host, port, &hints, &server_addr) != 0) {
+        fprintf(stderr, "cannot resolve %s:%s\n", host, port);
+        return 1;
+    }
+
+    static Client clients[MAX_CLIENTS];
+    for (int i = 0; i < MAX_CLIENTS; i++) {
+        clients[i].latencies_ms = malloc(MAX_SAMPLES_PER_CLIENT * sizeof(double));
+    }
+
+    printf("Target http://%s:%s%s, %ds per level, %s\n", host, port, request_path, seconds,
+           keep_alive ? "keep-alive" : "connection per request");
+    printf("%8s %10s %10s %9s %9s %9s %8s %8s\n",
+           "clients", "requests", "req/s", "p50 ms", "p99 ms", "max ms", "errors", "connects");
+    for (size_t i = 0; i < sizeof(CONCURRENCY_LEVELS) / sizeof(CONCURRENCY_LEVELS[0]); i++) {
+        run_level(clients, CONCURRENCY_LEVELS[i], seconds);
+    }
+
+    freeaddrinfo(server_addr);
+    return 0;
+}
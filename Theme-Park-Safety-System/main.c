@@ -18,11 +18,15 @@
 #include "driver/gpio.h"
 #include "esp_timer.h"
 #include "rom/ets_sys.h"
+#include "seqlock.h"
+#include "state_machine.h"
+#include "wcet.h"
+#include "supervisor.h"
 
 /* ===================== GPIO ASSIGNMENTS ===================== */
 
 // Indicator LEDs
-#define LED_SYSTEM_POWER          GPIO_NUM_5   // Heartbeat indicator
+#define LED_SYSTEM_POWER          GPIO_NUM_5   // Supervisor heartbeat; fast blink on a liveness fault
 #define LED_EMERGENCY_BRAKE       GPIO_NUM_4   // Fault / brake engaged
 #define LED_ALL_CLEAR             GPIO_NUM_19  // Ready-to-run indicator
 
@@ -39,6 +43,18 @@
 #define BUTTON_DEBOUNCE_TIME_MS       200     // Debounce window for E-Stop
 #define PROX_ECHO_TIMEOUT_US      30000       // ~5 meters max echo time
 
+/* Liveness supervision: longest gap between check-ins before the brake is engaged */
+#define SUPERVISOR_PERIOD_MS          50
+#define HEARTBEAT_HALF_PERIOD_MS      1000
+#define PROXIMITY_CHECKIN_DEADLINE_MS 250     // 50 ms loop + two echo timeouts, with margin
+#define RIDE_CTRL_CHECKIN_DEADLINE_MS 100     // 10 ms loop
+
+/* Set to 1 (or build with -DWCET_BENCHMARK=1) to time the E-Stop ISR instead of running the ride */
+#ifndef WCET_BENCHMARK
+#define WCET_BENCHMARK            0
+#endif
+#define ESTOP_ISR_BUDGET_US       10          // ISR body budget checked by the benchmark
+
 /* ===================== RTOS OBJECTS ===================== */
 
 SemaphoreHandle_t sem_emergency_stop;
@@ -54,25 +70,70 @@ typedef enum {
     RIDE_ALL_CLEAR,        // Ride may operate
     HALTED_BY_PROXIMITY,   // Automatic safety stop
     HALTED_BY_ESTOP,       // Manual emergency stop
-    AWAITING_RESTART       // Obstruction cleared, waiting for operator
+    AWAITING_RESTART,      // Obstruction cleared, waiting for operator
+    HALTED_BY_FAULT,       // A safety task missed its check-in; latched until reset
+    RIDE_STATE_COUNT
 } RideStatus;
 
 /*
- * Volatile is critical here: these variables are shared between tasks
- * and ISRs, and must never be cached by the compiler.
+ * Inputs to the safety state machine, collected by ride_control_task.
+ */
+typedef enum {
+    EVT_OBSTRUCTION_DETECTED,   // Proximity task saw an unsafe entry
+    EVT_ESTOP_PRESSED,          // E-Stop ISR fired (halt, or operator restart)
+    EVT_OBSTRUCTION_CLEARED,    // Latest reading shows the zone is clear
+    EVT_LIVENESS_FAULT,         // Supervisor latched a missed check-in
+    RIDE_EVENT_COUNT
+} RideEvent;
+
+/*
+ * One proximity measurement. distance_cm is -1 when the sensor failed,
+ * which is always reported as an obstruction.
+ */
+typedef struct {
+    int distance_cm;
+    bool obstruction_present;
+} ProximityReading;
+
+/*
+ * What diagnostics see: the ride state together with the reading the
+ * control task based it on, so the two can never be mixed from
+ * different moments.
+ */
+typedef struct {
+    RideStatus status;
+    ProximityReading proximity;
+} RideSnapshot;
+
+/*
+ * Multi-field shared state is published through seqlock snapshots:
+ * each has a single writer, and readers always get a consistent copy
+ * without taking a lock. Separate volatile globals could be read torn.
  */
-volatile RideStatus ride_status = RIDE_ALL_CLEAR;
-volatile bool is_obstruction_present = false;
-volatile int current_proximity_cm = -1;
+static SEQLOCK_SNAPSHOT(ProximityReading) proximity_snapshot;  // Writer: proximity_sensor_task
+static SEQLOCK_SNAPSHOT(RideSnapshot) ride_snapshot;           // Writer: ride_control_task
+
+/* Written only by the E-Stop ISR */
 volatile int64_t last_estop_isr_time_us = 0;
 
+/* Safety tasks watched by the liveness supervisor */
+static supervised_task_t proximity_liveness;
+static supervised_task_t ride_control_liveness;
+
+/* Set if the supervisor could not start: the ride must not run unwatched */
+static volatile bool supervisor_unavailable = false;
+
 /* ===================== FUNCTION PROTOTYPES ===================== */
 
-void system_power_monitor_task(void *pvParameters);
 void proximity_sensor_task(void *pvParameters);
 void ride_control_task(void *pvParameters);
 void status_output_task(void *pvParameters);
 static void IRAM_ATTR emergency_stop_isr(void *arg);
+static void engage_brake(void *context);
+static void liveness_safe_state(const supervised_task_t *culprit, void *context);
+#if WCET_BENCHMARK
+static void run_wcet_benchmarks(void);
+#endif
 
 /* ===================== MAIN APPLICATION ===================== */
 
@@ -104,16 +165,48 @@ void app_main(void)
     gpio_set_level(LED_EMERGENCY_BRAKE, 0);
     gpio_set_level(LED_ALL_CLEAR, 1);
 
+    /* Publish initial state before any reader starts */
+    ProximityReading no_reading = { .distance_cm = -1, .obstruction_present = false };
+    RideSnapshot initial_ride = { .status = RIDE_ALL_CLEAR, .proximity = no_reading };
+    seqlock_publish(&proximity_snapshot, &no_reading);
+    seqlock_publish(&ride_snapshot, &initial_ride);
+
     /* Create synchronization primitives */
     sem_emergency_stop = xSemaphoreCreateBinary();
     sem_proximity_event = xSemaphoreCreateBinary();
 
+#if WCET_BENCHMARK
+    /* Benchmark mode: no tasks or interrupts, so nothing disturbs the measurements */
+    run_wcet_benchmarks();
+    return;
+#endif
+
+    /* Register the safety tasks before they can check in */
+    supervisor_watch(&proximity_liveness, "Proximity", PROXIMITY_CHECKIN_DEADLINE_MS);
+    supervisor_watch(&ride_control_liveness, "RideCtrl", RIDE_CTRL_CHECKIN_DEADLINE_MS);
+
     /* Create tasks */
-    xTaskCreate(system_power_monitor_task, "PowerLED", 2048, NULL, 1, NULL);
     xTaskCreate(proximity_sensor_task,    "Proximity", 2048, NULL, 2, NULL);
     xTaskCreate(ride_control_task,         "RideCtrl",  2048, NULL, 3, NULL);
     xTaskCreate(status_output_task,        "Status",    2048, NULL, 1, NULL);
 
+    /*
+     * The supervisor replaces the power LED task: it blinks the heartbeat,
+     * feeds the task watchdog and engages the brake on a missed check-in.
+     * The status task is diagnostic only and is deliberately not watched.
+     */
+    const supervisor_config_t supervisor_cfg = {
+        .period_ms = SUPERVISOR_PERIOD_MS,
+        .heartbeat_gpio = LED_SYSTEM_POWER,
+        .heartbeat_half_period_ms = HEARTBEAT_HALF_PERIOD_MS,
+        .safe_state = liveness_safe_state,
+    };
+    if (!supervisor_start(&supervisor_cfg)) {
+        printf("ERROR: liveness supervisor failed to start - brake latched\n");
+        supervisor_unavailable = true;
+        engage_brake(NULL);
+    }
+
     /* Install ISR service and register E-Stop ISR */
     gpio_install_isr_service(0);
     gpio_isr_handler_add(BUTTON_EMERGENCY_STOP, emergency_stop_isr, NULL);
@@ -145,6 +238,32 @@ static void IRAM_ATTR emergency_stop_isr(void *arg)
     }
 }
 
+/* ===================== WCET BENCHMARK ===================== */
+
+#if WCET_BENCHMARK
+/* Outside the debounce window with an empty semaphore: the full path that gives it */
+static void estop_isr_setup_accept(void *context)
+{
+    last_estop_isr_time_us = 0;
+    xSemaphoreTake(sem_emergency_stop, 0);
+}
+
+/* A bounce inside the debounce window: the early-out path */
+static void estop_isr_setup_bounce(void *context)
+{
+    last_estop_isr_time_us = esp_timer_get_time();
+}
+
+static void run_wcet_benchmarks(void)
+{
+    static const wcet_case_t cases[] = {
+        { "emergency_stop_isr",        emergency_stop_isr, estop_isr_setup_accept, NULL, ESTOP_ISR_BUDGET_US },
+        { "emergency_stop_isr.bounce", emergency_stop_isr, estop_isr_setup_bounce, NULL, ESTOP_ISR_BUDGET_US },
+    };
+    wcet_run(cases, sizeof(cases) / sizeof(cases[0]), WCET_DEFAULT_ITERATIONS);
+}
+#endif
+
 /* ===================== PROXIMITY SENSOR TASK ===================== */
 
 /*
@@ -157,6 +276,9 @@ void proximity_sensor_task(void *pvParameters)
 {
     bool prev_obstruction = false;
 
+    /* Sensor failure is treated as unsafe */
+    const ProximityReading failed_reading = { .distance_cm = -1, .obstruction_present = true };
+
     while (1) {
         /* Trigger ultrasonic pulse */
         gpio_set_level(PROX_TRIG_PIN, 0);
@@ -169,9 +291,7 @@ void proximity_sensor_task(void *pvParameters)
         int64_t start_wait = esp_timer_get_time();
         while (!gpio_get_level(PROX_ECHO_PIN)) {
             if ((esp_timer_get_time() - start_wait) > PROX_ECHO_TIMEOUT_US) {
-                /* Sensor failure is treated as unsafe */
-                is_obstruction_present = true;
-                current_proximity_cm = -1;
+                seqlock_publish(&proximity_snapshot, &failed_reading);
                 goto sensor_delay;
             }
         }
@@ -180,8 +300,7 @@ void proximity_sensor_task(void *pvParameters)
         int64_t echo_start = esp_timer_get_time();
         while (gpio_get_level(PROX_ECHO_PIN)) {
             if ((esp_timer_get_time() - echo_start) > PROX_ECHO_TIMEOUT_US) {
-                is_obstruction_present = true;
-                current_proximity_cm = -1;
+                seqlock_publish(&proximity_snapshot, &failed_reading);
                 goto sensor_delay;
             }
         }
@@ -191,11 +310,12 @@ void proximity_sensor_task(void *pvParameters)
         int duration_us = (int)(echo_end - echo_start);
         int distance_cm = (int)(duration_us * 0.0343f / 2.0f);
 
-        current_proximity_cm = distance_cm;
         bool obstruction_now = (distance_cm > 0 &&
                                 distance_cm < PROXIMITY_THRESHOLD_CM);
 
-        is_obstruction_present = obstruction_now;
+        ProximityReading reading = { .distance_cm = distance_cm,
+                                     .obstruction_present = obstruction_now };
+        seqlock_publish(&proximity_snapshot, &reading);
 
         /* Generate event only on unsafe entry */
         if (obstruction_now && !prev_obstruction) {
@@ -205,10 +325,83 @@ void proximity_sensor_task(void *pvParameters)
         prev_obstruction = obstruction_now;
 
 sensor_delay:
+        supervisor_checkin(&proximity_liveness);
         vTaskDelay(pdMS_TO_TICKS(50));
     }
 }
 
+/* ===================== RIDE SAFETY STATE MACHINE ===================== */
+
+/* State the guards and actions work on; owned by ride_control_task */
+typedef struct {
+    ProximityReading proximity;
+} RideContext;
+
+static bool zone_is_clear(void *context)
+{
+    return !((RideContext *)context)->proximity.obstruction_present;
+}
+
+static void engage_brake(void *context)
+{
+    gpio_set_level(LED_EMERGENCY_BRAKE, 1);
+    gpio_set_level(LED_ALL_CLEAR, 0);
+}
+
+static void release_brake(void *context)
+{
+    gpio_set_level(LED_EMERGENCY_BRAKE, 0);
+    gpio_set_level(LED_ALL_CLEAR, 1);
+}
+
+/*
+ * The complete transition set. Restart is only possible through an
+ * E-Stop press with the zone clear; everything else either halts or
+ * leaves the state unchanged. A liveness fault halts from any state
+ * and nothing leaves HALTED_BY_FAULT short of a reset.
+ */
+#define RIDE_TRANSITIONS(X)                                                                        \
+    /* state                event                      guard          action         next */       \
+    X(RIDE_ALL_CLEAR,       EVT_OBSTRUCTION_DETECTED,  NULL,          engage_brake,  HALTED_BY_PROXIMITY) \
+    X(RIDE_ALL_CLEAR,       EVT_ESTOP_PRESSED,         NULL,          engage_brake,  HALTED_BY_ESTOP)     \
+    X(RIDE_ALL_CLEAR,       EVT_OBSTRUCTION_CLEARED,   NULL,          NULL,          RIDE_ALL_CLEAR)      \
+    X(RIDE_ALL_CLEAR,       EVT_LIVENESS_FAULT,        NULL,          engage_brake,  HALTED_BY_FAULT)     \
+    X(HALTED_BY_PROXIMITY,  EVT_OBSTRUCTION_DETECTED,  NULL,          NULL,          HALTED_BY_PROXIMITY) \
+    X(HALTED_BY_PROXIMITY,  EVT_ESTOP_PRESSED,         NULL,          engage_brake,  HALTED_BY_ESTOP)     \
+    X(HALTED_BY_PROXIMITY,  EVT_OBSTRUCTION_CLEARED,   NULL,          NULL,          AWAITING_RESTART)    \
+    X(HALTED_BY_PROXIMITY,  EVT_LIVENESS_FAULT,        NULL,          engage_brake,  HALTED_BY_FAULT)     \
+    X(HALTED_BY_ESTOP,      EVT_OBSTRUCTION_DETECTED,  NULL,          NULL,          HALTED_BY_ESTOP)     \
+    X(HALTED_BY_ESTOP,      EVT_ESTOP_PRESSED,         zone_is_clear, release_brake, RIDE_ALL_CLEAR)      \
+    X(HALTED_BY_ESTOP,      EVT_OBSTRUCTION_CLEARED,   NULL,          NULL,          HALTED_BY_ESTOP)     \
+    X(HALTED_BY_ESTOP,      EVT_LIVENESS_FAULT,        NULL,          engage_brake,  HALTED_BY_FAULT)     \
+    X(AWAITING_RESTART,     EVT_OBSTRUCTION_DETECTED,  NULL,          engage_brake,  HALTED_BY_PROXIMITY) \
+    X(AWAITING_RESTART,     EVT_ESTOP_PRESSED,         zone_is_clear, release_brake, RIDE_ALL_CLEAR)      \
+    X(AWAITING_RESTART,     EVT_OBSTRUCTION_CLEARED,   NULL,          NULL,          AWAITING_RESTART)    \
+    X(AWAITING_RESTART,     EVT_LIVENESS_FAULT,        NULL,          engage_brake,  HALTED_BY_FAULT)     \
+    X(HALTED_BY_FAULT,      EVT_OBSTRUCTION_DETECTED,  NULL,          NULL,          HALTED_BY_FAULT)     \
+    X(HALTED_BY_FAULT,      EVT_ESTOP_PRESSED,         NULL,          NULL,          HALTED_BY_FAULT)     \
+    X(HALTED_BY_FAULT,      EVT_OBSTRUCTION_CLEARED,   NULL,          NULL,          HALTED_BY_FAULT)     \
+    X(HALTED_BY_FAULT,      EVT_LIVENESS_FAULT,        NULL,          NULL,          HALTED_BY_FAULT)
+
+FSM_DEFINE_TABLE(ride_transition_table, RIDE_TRANSITIONS, RIDE_STATE_COUNT, RIDE_EVENT_COUNT);
+
+static const char *const ride_state_names[RIDE_STATE_COUNT] = {
+    [RIDE_ALL_CLEAR]      = "ALL_CLEAR",
+    [HALTED_BY_PROXIMITY] = "HALTED_BY_PROXIMITY",
+    [HALTED_BY_ESTOP]     = "HALTED_BY_ESTOP",
+    [AWAITING_RESTART]    = "AWAITING_RESTART",
+    [HALTED_BY_FAULT]     = "HALTED_BY_FAULT",
+};
+
+static const char *const ride_event_names[RIDE_EVENT_COUNT] = {
+    [EVT_OBSTRUCTION_DETECTED] = "OBSTRUCTION_DETECTED",
+    [EVT_ESTOP_PRESSED]        = "ESTOP_PRESSED",
+    [EVT_OBSTRUCTION_CLEARED]  = "OBSTRUCTION_CLEARED",
+    [EVT_LIVENESS_FAULT]       = "LIVENESS_FAULT",
+};
+
+static fsm_t ride_fsm;
+
 /* ===================== RIDE CONTROL TASK ===================== */
 
 /*
@@ -217,46 +410,38 @@ sensor_delay:
  */
 void ride_control_task(void *pvParameters)
 {
-    while (1) {
+    RideContext context;
+    seqlock_read(&proximity_snapshot, &context.proximity);
+    fsm_init(&ride_fsm, &ride_transition_table[0][0], RIDE_EVENT_COUNT,
+             RIDE_ALL_CLEAR, &context);
 
-        /* Proximity-triggered halt */
-        if ((ride_status == RIDE_ALL_CLEAR ||
-             ride_status == AWAITING_RESTART) &&
-            xSemaphoreTake(sem_proximity_event, 0)) {
+    while (1) {
+        seqlock_read(&proximity_snapshot, &context.proximity);
 
-            ride_status = HALTED_BY_PROXIMITY;
-            gpio_set_level(LED_EMERGENCY_BRAKE, 1);
-            gpio_set_level(LED_ALL_CLEAR, 0);
+        /* A liveness fault outranks every other event, so no restart can slip past it */
+        if (supervisor_faulted() || supervisor_unavailable) {
+            fsm_dispatch(&ride_fsm, EVT_LIVENESS_FAULT);
         }
 
-        /* Emergency stop handling */
+        /* Events are dispatched in the same priority order as before. An obstruction is
+         * acted on by level as well as by event: a reading is published before its event
+         * is given, and a failed reading (unsafe) raises no event at all. */
+        bool obstruction_event = xSemaphoreTake(sem_proximity_event, 0);
+        if (obstruction_event || context.proximity.obstruction_present) {
+            fsm_dispatch(&ride_fsm, EVT_OBSTRUCTION_DETECTED);
+        }
         if (xSemaphoreTake(sem_emergency_stop, 0)) {
-            switch (ride_status) {
-
-                case RIDE_ALL_CLEAR:
-                case HALTED_BY_PROXIMITY:
-                    ride_status = HALTED_BY_ESTOP;
-                    gpio_set_level(LED_EMERGENCY_BRAKE, 1);
-                    gpio_set_level(LED_ALL_CLEAR, 0);
-                    break;
-
-                case HALTED_BY_ESTOP:
-                case AWAITING_RESTART:
-                    if (!is_obstruction_present) {
-                        ride_status = RIDE_ALL_CLEAR;
-                        gpio_set_level(LED_EMERGENCY_BRAKE, 0);
-                        gpio_set_level(LED_ALL_CLEAR, 1);
-                    }
-                    break;
-            }
+            fsm_dispatch(&ride_fsm, EVT_ESTOP_PRESSED);
         }
-
-        /* Automatic transition when obstruction clears */
-        if (ride_status == HALTED_BY_PROXIMITY &&
-            !is_obstruction_present) {
-            ride_status = AWAITING_RESTART;
+        if (!context.proximity.obstruction_present) {
+            fsm_dispatch(&ride_fsm, EVT_OBSTRUCTION_CLEARED);
         }
 
+        RideSnapshot snapshot = { .status = (RideStatus)ride_fsm.state,
+                                  .proximity = context.proximity };
+        seqlock_publish(&ride_snapshot, &snapshot);
+
+        supervisor_checkin(&ride_control_liveness);
         vTaskDelay(pdMS_TO_TICKS(10));
     }
 }
@@ -269,10 +454,25 @@ void ride_control_task(void *pvParameters)
  */
 void status_output_task(void *pvParameters)
 {
+    RideSnapshot snapshot;
+    uint32_t trace_cursor = 0;
+    fsm_trace_entry_t transition;
+
     while (1) {
         const char *status;
 
-        switch (ride_status) {
+        /* Report state machine transitions since the last cycle */
+        while (fsm_trace_next(&ride_fsm, &trace_cursor, &transition)) {
+            printf("[%lu] Transition %s --%s--> %s\n",
+                   transition.tick,
+                   ride_state_names[transition.from],
+                   ride_event_names[transition.event],
+                   ride_state_names[transition.to]);
+        }
+
+        seqlock_read(&ride_snapshot, &snapshot);
+
+        switch (snapshot.status) {
             case HALTED_BY_PROXIMITY:
                 status = "Obstruction Detected - Ride Halted";
                 break;
@@ -282,6 +482,9 @@ void status_output_task(void *pvParameters)
             case AWAITING_RESTART:
                 status = "Clear - Awaiting Operator Restart";
                 break;
+            case HALTED_BY_FAULT:
+                status = "Liveness Fault - Brake Latched Until Reset";
+                break;
             default:
                 status = "All Clear";
                 break;
@@ -289,25 +492,25 @@ void status_output_task(void *pvParameters)
 
         printf("[%lu] Proximity=%dcm | State=%s\n",
                xTaskGetTickCount(),
-               current_proximity_cm,
+               snapshot.proximity.distance_cm,
                status);
 
+        /* Missed check-ins are printed here, off the supervisor's timer callback */
+        supervisor_report_misses();
+
         vTaskDelay(pdMS_TO_TICKS(250));
     }
 }
 
-/* ===================== POWER LED TASK ===================== */
+/* ===================== LIVENESS SAFE STATE ===================== */
 
 /*
- * Lowest-priority heartbeat indicator.
- * Confirms system liveness.
+ * Called by the supervisor on every tick once a check-in is missed.
+ * Drives the brake outputs directly rather than through the state
+ * machine: the task that stopped checking in may be ride_control_task
+ * itself. While it is still alive it also moves to HALTED_BY_FAULT.
  */
-void system_power_monitor_task(void *pvParameters)
+static void liveness_safe_state(const supervised_task_t *culprit, void *context)
 {
-    while (1) {
-        gpio_set_level(LED_SYSTEM_POWER, 1);
-        vTaskDelay(pdMS_TO_TICKS(1000));
-        gpio_set_level(LED_SYSTEM_POWER, 0);
-        vTaskDelay(pdMS_TO_TICKS(1000));
-    }
+    engage_brake(NULL);
 }
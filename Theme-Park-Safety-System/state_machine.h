@@ -0,0 +1,123 @@
+/***********************************************************************
+ * Table-Driven State Machine Engine
+ * States, events, guards and actions live in one constant table that
+ * can be audited in a single place. Dispatch is a direct
+ * table[state][event] lookup, so every event costs the same.
+ *
+ * Tables are declared as an X-macro list of
+ *     X(state, event, guard, action, next_state)
+ * rows and expanded with FSM_DEFINE_TABLE, which refuses to compile
+ * unless every (state, event) pair appears exactly once:
+ *   - a duplicated pair redeclares the same enumerator,
+ *   - a missing pair leaves the row count short of states * events.
+ *
+ * Every taken transition is recorded in a small ring buffer so the
+ * recent history can be dumped by a lower-priority task.
+ ***********************************************************************/
+#ifndef STATE_MACHINE_H
+#define STATE_MACHINE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#define FSM_TRACE_DEPTH   32      // Transitions kept in the trace ring (power of two)
+
+typedef bool (*fsm_guard_t)(void *context);
+typedef void (*fsm_action_t)(void *context);
+
+typedef struct {
+    uint8_t next_state;
+    fsm_guard_t guard;      // NULL: always allowed. When false, the event is ignored.
+    fsm_action_t action;    // NULL: no side effect
+} fsm_transition_t;
+
+typedef struct {
+    TickType_t tick;
+    uint8_t from;
+    uint8_t event;
+    uint8_t to;
+} fsm_trace_entry_t;
+
+typedef struct {
+    const fsm_transition_t *table;   // [state_count][event_count], row-major
+    uint8_t event_count;
+    uint8_t state;
+    void *context;                   // Passed to guards and actions
+
+    fsm_trace_entry_t trace[FSM_TRACE_DEPTH];
+    volatile uint32_t trace_head;    // Total transitions recorded; written by the dispatching task only
+} fsm_t;
+
+/* Table expansion helpers; use FSM_DEFINE_TABLE rather than these directly. */
+#define FSM_PAIR_ID_(state, event, guard, action, next)  FSM_PAIR_##state##_##event,
+#define FSM_CELL_(state, event, guard, action, next)     [state][event] = { (next), (guard), (action) },
+
+/* Defines `static const fsm_transition_t name[state_count][event_count]` from an X-macro list. */
+#define FSM_DEFINE_TABLE(name, transitions, state_count, event_count)                  \
+    enum { transitions(FSM_PAIR_ID_) name##_PAIR_COUNT };                              \
+    _Static_assert(name##_PAIR_COUNT == (state_count) * (event_count),                 \
+                   #name ": every (state, event) pair must be handled exactly once");  \
+    static const fsm_transition_t name[(state_count)][(event_count)] = { transitions(FSM_CELL_) }
+
+static inline void fsm_init(fsm_t *fsm, const fsm_transition_t *table, uint8_t event_count,
+                            uint8_t initial_state, void *context)
+{
+    fsm->table = table;
+    fsm->event_count = event_count;
+    fsm->state = initial_state;
+    fsm->context = context;
+    fsm->trace_head = 0;
+}
+
+/* O(1) dispatch: one lookup, at most one guard and one action. Returns the new state. */
+static inline uint8_t fsm_dispatch(fsm_t *fsm, uint8_t event)
+{
+    const fsm_transition_t *t = &fsm->table[fsm->state * fsm->event_count + event];
+
+    if (t->guard != NULL && !t->guard(fsm->context)) {
+        return fsm->state;
+    }
+
+    uint8_t from = fsm->state;
+    fsm->state = t->next_state;
+    if (t->action != NULL) {
+        t->action(fsm->context);
+    }
+
+    /* Trace hook: only record events that did something */
+    if (from != t->next_state || t->action != NULL) {
+        uint32_t head = fsm->trace_head;
+        fsm_trace_entry_t *entry = &fsm->trace[head & (FSM_TRACE_DEPTH - 1)];
+        entry->tick = xTaskGetTickCount();
+        entry->from = from;
+        entry->event = event;
+        entry->to = t->next_state;
+        __atomic_store_n(&fsm->trace_head, head + 1, __ATOMIC_RELEASE);
+    }
+    return fsm->state;
+}
+
+/*
+ * Copies the next unread trace entry after *cursor. Returns false when the
+ * reader is up to date. A reader that falls more than FSM_TRACE_DEPTH
+ * entries behind skips ahead to the oldest entry still in the ring.
+ */
+static inline bool fsm_trace_next(const fsm_t *fsm, uint32_t *cursor, fsm_trace_entry_t *out)
+{
+    uint32_t head = __atomic_load_n(&fsm->trace_head, __ATOMIC_ACQUIRE);
+
+    if (*cursor == head) {
+        return false;
+    }
+    if (head - *cursor > FSM_TRACE_DEPTH) {
+        *cursor = head - FSM_TRACE_DEPTH;
+    }
+    *out = fsm->trace[*cursor & (FSM_TRACE_DEPTH - 1)];
+    (*cursor)++;
+    return true;
+}
+
+#endif /* STATE_MACHINE_H */
@@ -0,0 +1,150 @@
+/***********************************************************************
+ * Liveness Supervisor - see supervisor.h
+ ***********************************************************************/
+#include <stdio.h>
+#include "supervisor.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "driver/gpio.h"
+#include "esp_timer.h"
+#include "esp_task_wdt.h"
+#include "esp_idf_version.h"
+
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0)
+#define SUPERVISOR_WDT_USER 1
+#endif
+
+static supervised_task_t *registry;
+static supervisor_config_t config;
+static esp_timer_handle_t supervisor_timer;
+static const supervised_task_t *volatile culprit;   // First task that missed; non-NULL latches the fault
+static uint32_t heartbeat_elapsed_ms;
+static int heartbeat_level;
+#ifdef SUPERVISOR_WDT_USER
+static esp_task_wdt_user_handle_t watchdog_user;    // NULL when the watchdog is unavailable
+#endif
+
+void supervisor_watch(supervised_task_t *task, const char *name, uint32_t deadline_ms)
+{
+    task->name = name;
+    task->deadline_ms = deadline_ms;
+    task->checkins = 0;
+    task->seen_checkins = 0;
+    task->last_progress_us = esp_timer_get_time();
+    task->silent_ms_at_miss = 0;
+    task->missed = false;
+    task->reported = false;
+    task->next = registry;
+    registry = task;
+}
+
+static void toggle_heartbeat(void)
+{
+    heartbeat_level = !heartbeat_level;
+    gpio_set_level((gpio_num_t)config.heartbeat_gpio, heartbeat_level);
+}
+
+static void supervisor_tick(void *arg)
+{
+    (void)arg;
+    int64_t now_us = esp_timer_get_time();
+
+    for (supervised_task_t *task = registry; task != NULL; task = task->next) {
+        uint32_t checkins = __atomic_load_n(&task->checkins, __ATOMIC_RELAXED);
+        if (checkins != task->seen_checkins) {
+            task->seen_checkins = checkins;
+            task->last_progress_us = now_us;
+            continue;
+        }
+
+        uint32_t silent_ms = (uint32_t)((now_us - task->last_progress_us) / 1000);
+        if (!task->missed && silent_ms > task->deadline_ms) {
+            task->silent_ms_at_miss = silent_ms;
+            __atomic_store_n(&task->missed, true, __ATOMIC_RELEASE);   // After silent_ms_at_miss
+            if (culprit == NULL) {
+                culprit = task;
+            }
+        }
+    }
+
+    if (culprit != NULL && config.safe_state != NULL) {
+        config.safe_state(culprit, config.context);
+    }
+
+    if (config.heartbeat_gpio != SUPERVISOR_NO_LED) {
+        heartbeat_elapsed_ms += config.period_ms;
+        if (culprit != NULL || heartbeat_elapsed_ms >= config.heartbeat_half_period_ms) {
+            heartbeat_elapsed_ms = 0;
+            toggle_heartbeat();
+        }
+    }
+
+#ifdef SUPERVISOR_WDT_USER
+    if (watchdog_user != NULL) {
+        esp_task_wdt_reset_user(watchdog_user);
+    }
+#endif
+}
+
+void supervisor_report_misses(void)
+{
+    if (culprit == NULL) {
+        return;   // Nothing missed yet: one load, no printing
+    }
+    for (supervised_task_t *task = registry; task != NULL; task = task->next) {
+        if (__atomic_load_n(&task->missed, __ATOMIC_ACQUIRE) && !task->reported) {
+            task->reported = true;
+            printf("SUPERVISOR: %s missed its check-in (silent %lu ms, deadline %lu ms) - safe state\n",
+                   task->name, (unsigned long)task->silent_ms_at_miss, (unsigned long)task->deadline_ms);
+        }
+    }
+}
+
+bool supervisor_start(const supervisor_config_t *cfg)
+{
+    if (cfg->period_ms == 0) {
+        return false;
+    }
+    config = *cfg;
+
+    int64_t now_us = esp_timer_get_time();
+    for (supervised_task_t *task = registry; task != NULL; task = task->next) {
+        task->last_progress_us = now_us;
+    }
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = supervisor_tick,
+        .name = "supervisor",
+    };
+    if (esp_timer_create(&timer_args, &supervisor_timer) != ESP_OK) {
+        return false;
+    }
+
+    /* A watchdog user of its own: the esp_timer task stays unsubscribed */
+#ifdef SUPERVISOR_WDT_USER
+    if (esp_task_wdt_add_user("supervisor", &watchdog_user) != ESP_OK) {
+        watchdog_user = NULL;
+        printf("SUPERVISOR: task watchdog unavailable, running without it\n");
+    }
+#else
+    printf("SUPERVISOR: task watchdog users need ESP-IDF 5.0, running without it\n");
+#endif
+
+    if (esp_timer_start_periodic(supervisor_timer, (uint64_t)config.period_ms * 1000) != ESP_OK) {
+#ifdef SUPERVISOR_WDT_USER
+        if (watchdog_user != NULL) {
+            esp_task_wdt_delete_user(watchdog_user);   // Nothing would feed it
+            watchdog_user = NULL;
+        }
+#endif
+        esp_timer_delete(supervisor_timer);
+        supervisor_timer = NULL;
+        return false;
+    }
+    return true;
+}
+
+bool supervisor_faulted(void)
+{
+    return culprit != NULL;
+}
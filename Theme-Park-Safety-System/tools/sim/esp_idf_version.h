@@ -0,0 +1,10 @@
+/***********************************************************************
+ * Host simulation: the ESP-IDF release the simulated APIs follow
+ ***********************************************************************/
+#ifndef SIM_ESP_IDF_VERSION_H
+#define SIM_ESP_IDF_VERSION_H
+
+#define ESP_IDF_VERSION_VAL(major, minor, patch) (((major) << 16) | ((minor) << 8) | (patch))
+#define ESP_IDF_VERSION ESP_IDF_VERSION_VAL(5, 1, 0)
+
+#endif /* SIM_ESP_IDF_VERSION_H */
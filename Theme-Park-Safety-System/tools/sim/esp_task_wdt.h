@@ -0,0 +1,18 @@
+/***********************************************************************
+ * Host simulation: task watchdog - see sim_kernel.c
+ ***********************************************************************/
+#ifndef SIM_ESP_TASK_WDT_H
+#define SIM_ESP_TASK_WDT_H
+
+#include "esp_err.h"
+#include "freertos/task.h"
+
+typedef struct sim_wdt_user *esp_task_wdt_user_handle_t;
+
+esp_err_t esp_task_wdt_add(TaskHandle_t task);
+esp_err_t esp_task_wdt_reset(void);
+esp_err_t esp_task_wdt_add_user(const char *name, esp_task_wdt_user_handle_t *user);
+esp_err_t esp_task_wdt_reset_user(esp_task_wdt_user_handle_t user);
+esp_err_t esp_task_wdt_delete_user(esp_task_wdt_user_handle_t user);
+
+#endif /* SIM_ESP_TASK_WDT_H */
@@ -0,0 +1,41 @@
+/***********************************************************************
+ * Host simulation: the ride firmware, built unmodified
+ * main.c is included rather than compiled on its own so the harness
+ * can read the snapshot the firmware keeps private, without the
+ * firmware having to export anything for testing.
+ ***********************************************************************/
+/* ESP-IDF callback signatures leave parameters unused; main.c builds without -Wextra */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#include "../../main.c"
+#pragma GCC diagnostic pop
+#include "firmware.h"
+
+const int firmware_pin_brake_led = LED_EMERGENCY_BRAKE;
+const int firmware_pin_all_clear_led = LED_ALL_CLEAR;
+const int firmware_pin_estop = BUTTON_EMERGENCY_STOP;
+const int firmware_pin_trigger = PROX_TRIG_PIN;
+const int firmware_pin_echo = PROX_ECHO_PIN;
+const int firmware_state_count = RIDE_STATE_COUNT;
+
+void firmware_read_ride(firmware_ride_view_t *view)
+{
+    RideSnapshot snapshot;
+    seqlock_read(&ride_snapshot, &snapshot);
+
+    view->state = snapshot.status;
+    view->state_name = ride_state_names[snapshot.status];
+    view->all_clear = snapshot.status == RIDE_ALL_CLEAR;
+    view->distance_cm = snapshot.proximity.distance_cm;
+    view->obstruction_present = snapshot.proximity.obstruction_present;
+}
+
+const char *firmware_state_name(int state)
+{
+    return ride_state_names[state];
+}
+
+uint32_t firmware_transition_count(void)
+{
+    return __atomic_load_n(&ride_fsm.trace_head, __ATOMIC_ACQUIRE);
+}
@@ -0,0 +1,35 @@
+/***********************************************************************
+ * Host simulation: what the harness may see of the ride firmware
+ ***********************************************************************/
+#ifndef SIM_FIRMWARE_H
+#define SIM_FIRMWARE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct {
+    int state;                      // RideStatus of the last published snapshot
+    const char *state_name;
+    bool all_clear;                 // state == RIDE_ALL_CLEAR
+    int distance_cm;                // Reading the state was based on (-1: sensor failure)
+    bool obstruction_present;
+} firmware_ride_view_t;
+
+extern const int firmware_pin_brake_led;
+extern const int firmware_pin_all_clear_led;
+extern const int firmware_pin_estop;
+extern const int firmware_pin_trigger;
+extern const int firmware_pin_echo;
+extern const int firmware_state_count;
+
+void app_main(void);
+
+/* The ride snapshot exactly as the status task would read it. */
+void firmware_read_ride(firmware_ride_view_t *view);
+
+const char *firmware_state_name(int state);
+
+/* State machine transitions taken so far. */
+uint32_t firmware_transition_count(void);
+
+#endif /* SIM_FIRMWARE_H */
@@ -0,0 +1,45 @@
+/***********************************************************************
+ * Host simulation: FreeRTOS core types and port macros
+ * Only the subset the ride firmware uses. Everything is backed by the
+ * discrete-event kernel in sim_kernel.c; see ride_stress.c.
+ ***********************************************************************/
+#ifndef SIM_FREERTOS_H
+#define SIM_FREERTOS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef unsigned long TickType_t;     // 32-bit on the ESP32, matches the firmware's %lu formats
+
+#define pdTRUE  1
+#define pdFALSE 0
+#define pdPASS  1
+#define pdFAIL  0
+
+#define configTICK_RATE_HZ      100     // ESP-IDF default CONFIG_FREERTOS_HZ
+#define configMAX_PRIORITIES    25
+#define portTICK_PERIOD_MS      (1000 / configTICK_RATE_HZ)
+#define portMAX_DELAY           ((TickType_t)0xffffffffu)
+#define pdMS_TO_TICKS(ms)       ((TickType_t)(((uint64_t)(ms) * configTICK_RATE_HZ) / 1000))
+#define pdTICKS_TO_MS(ticks)    ((TickType_t)(((uint64_t)(ticks) * 1000) / configTICK_RATE_HZ))
+
+#define IRAM_ATTR
+#define DRAM_ATTR
+
+/* No simulated time passes inside a masked section, so masking is a no-op */
+#define portSET_INTERRUPT_MASK_FROM_ISR()       0
+#define portCLEAR_INTERRUPT_MASK_FROM_ISR(x)    ((void)(x))
+
+#define portYIELD_FROM_ISR()    sim_yield_from_isr()
+void sim_yield_from_isr(void);
+
+/* Firmware console output is captured by the simulator (quiet unless -v) */
+int sim_printf(const char *format, ...) __attribute__((format(printf, 1, 2)));
+#ifndef SIM_HARNESS
+#define printf sim_printf
+#endif
+
+#endif /* SIM_FREERTOS_H */
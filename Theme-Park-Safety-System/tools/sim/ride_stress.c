@@ -0,0 +1,555 @@
+/***********************************************************************
+ * Ride Safety Stress and Fault-Injection Run (host)
+ * Runs the unmodified ride firmware (main.c + supervisor.c) on the
+ * simulation kernel against a scripted plant for simulated hours,
+ * much faster than real time, while injecting faults:
+ *   - E-Stop bounce floods: bursts of hundreds of edges on the
+ *     E-Stop line, each one running the ISR,
+ *   - echo stuck high: the echo line held high for a while,
+ *   - sensor dropouts: no echo at all for a while,
+ *   - CPU hogs: extra tasks burning CPU at a chosen priority.
+ * Obstructions come and go at random and an operator presses the
+ * (bouncing) E-Stop now and then, which halts or restarts the ride.
+ *
+ * Invariants, checked every millisecond of simulated time:
+ *   brake-latency  the brake output is on once an obstruction has
+ *                  been present for --brake-deadline-ms,
+ *   clear-obstructed  the published ride state is never ALL_CLEAR
+ *                  together with a reading that says obstruction,
+ *   outputs        brake and all-clear outputs are never both on or
+ *                  both off.
+ * Violations are reported with the firmware's recent console output.
+ *
+ * Build (from the Theme-Park-Safety-System directory):
+ *   cc -O2 -I tools/sim -o ride_stress tools/sim/ride_stress.c tools/sim/sim_kernel.c \
+ *      tools/sim/firmware.c supervisor.c -lm
+ * Usage:
+ *   ./ride_stress [--hours H] [--seed N] [--brake-deadline-ms X] [--no-faults]
+ *                 [--bounce-every-s S] [--bounce-edges N]
+ *                 [--stuck-every-s S] [--stuck-ms MS]
+ *                 [--dropout-every-s S] [--dropout-ms MS]
+ *                 [--hogs N] [--hog-priority P] [--hog-busy-ms MS] [--hog-period-ms MS]
+ *                 [--obstruction-every-s S] [--obstruction-for-s S]
+ *                 [--estop-every-s S] [-v]
+ * A rate of 0 disables that fault. Runs are deterministic for a seed.
+ * Ends with a STRESS {...} JSON line; the exit status is 1 if any
+ * invariant was violated.
+ ***********************************************************************/
+#define _POSIX_C_SOURCE 200809L
+#define SIM_HARNESS
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "sim_kernel.h"
+#include "firmware.h"
+#include "../../supervisor.h"
+
+#define US_PER_S            1000000LL
+#define US_PER_MS           1000LL
+#define ECHO_US_PER_CM      58          // Round trip at 343 m/s
+#define ECHO_START_US       250         // HC-SR04: burst, then the echo line rises
+#define TRIGGER_MIN_US      10
+#define MAX_STATES          8
+
+typedef struct {
+    double hours;
+    uint32_t seed;
+    uint32_t brake_deadline_ms;
+    uint32_t check_us;
+    double obstruction_every_s;         // Mean clear time between obstructions
+    double obstruction_for_s;           // Mean obstruction duration
+    double estop_every_s;               // Mean time between operator presses
+    double bounce_every_s;
+    uint32_t bounce_edges;
+    double stuck_every_s;
+    uint32_t stuck_ms;
+    double dropout_every_s;
+    uint32_t dropout_ms;
+    uint32_t hogs;
+    uint32_t hog_priority;
+    uint32_t hog_busy_ms;
+    uint32_t hog_period_ms;
+    uint32_t max_reports;
+    bool verbose;
+} options_t;
+
+static options_t options = {
+    .hours = 1.0,
+    .seed = 1,
+    .brake_deadline_ms = 250,           // 50 ms sensor period + two echo timeouts + 10 ms control loop, with margin
+    .check_us = 1000,
+    .obstruction_every_s = 20.0,
+    .obstruction_for_s = 2.0,
+    .estop_every_s = 30.0,
+    .bounce_every_s = 60.0,
+    .bounce_edges = 200,
+    .stuck_every_s = 300.0,
+    .stuck_ms = 500,
+    .dropout_every_s = 120.0,
+    .dropout_ms = 300,
+    .hogs = 2,
+    .hog_priority = 1,
+    .hog_busy_ms = 20,
+    .hog_period_ms = 50,
+    .max_reports = 5,
+};
+
+/* ===================== RANDOM ===================== */
+
+static uint64_t rng_state;
+
+static double random_unit(void)
+{
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return ((rng_state * 0x2545F4914F6CDD1DULL) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static int64_t random_between_us(int64_t low, int64_t high)
+{
+    return low + (int64_t)(random_unit() * (double)(high - low));
+}
+
+static int64_t random_exponential_us(double mean_s)
+{
+    return (int64_t)(-mean_s * log(1.0 - random_unit()) * US_PER_S);
+}
+
+/* ===================== PLANT ===================== */
+
+static struct {
+    bool obstructed;
+    int64_t obstructed_since_us;
+    bool brake_seen;                    // Brake observed on during the current obstruction
+    bool latency_violated;              // Current obstruction already reported
+
+    int64_t trigger_rise_us;
+    bool ranging;                       // Echo in progress, new triggers ignored
+    uint32_t echo_generation;           // Invalidates scheduled echo edges when a fault starts or ends
+    int64_t stuck_until_us;
+    int64_t dropout_until_us;
+    int estop_level;
+} plant;
+
+static struct {
+    uint64_t obstructions;
+    uint64_t measurements;
+    uint64_t blind_measurements;        // Triggers answered by no echo or a stuck line
+    uint64_t estop_presses;
+    uint64_t bounce_floods;
+    uint64_t bounce_edges;
+    uint64_t stuck_faults;
+    uint64_t dropout_faults;
+    uint64_t samples;
+    uint64_t state_samples[MAX_STATES];
+    int64_t *latencies_us;
+    size_t latency_count, latency_capacity;
+    uint64_t violations_latency;
+    uint64_t violations_clear_obstructed;
+    uint64_t violations_outputs;
+    uint32_t reports;
+} run;
+
+static void record_latency(int64_t latency_us)
+{
+    if (run.latency_count == run.latency_capacity) {
+        run.latency_capacity = run.latency_capacity ? run.latency_capacity * 2 : 1024;
+        run.latencies_us = realloc(run.latencies_us, run.latency_capacity * sizeof(int64_t));
+        if (run.latencies_us == NULL) {
+            fprintf(stderr, "out of memory\n");
+            exit(2);
+        }
+    }
+    run.latencies_us[run.latency_count++] = latency_us;
+}
+
+static void drive_echo(int level)
+{
+    sim_gpio_drive(firmware_pin_echo, level);
+}
+
+static void echo_edge(void *arg)
+{
+    uint32_t generation = (uint32_t)(uintptr_t)arg >> 1;
+    int level = (int)((uintptr_t)arg & 1);
+    if (generation != plant.echo_generation) return;
+    drive_echo(level);
+    if (level == 0) plant.ranging = false;
+}
+
+static void *echo_arg(int level)
+{
+    return (void *)(uintptr_t)((plant.echo_generation << 1) | (uint32_t)level);
+}
+
+/* The HC-SR04 answers a trigger pulse with an echo as long as the round trip */
+static void start_ranging(void)
+{
+    int64_t now = sim_now_us();
+    run.measurements++;
+    if (now < plant.stuck_until_us || now < plant.dropout_until_us) {
+        run.blind_measurements++;
+        return;
+    }
+    int distance_cm = plant.obstructed ? (int)random_between_us(5, 25)
+                                       : (int)random_between_us(80, 300);
+    int64_t rise_us = now + ECHO_START_US;
+    plant.ranging = true;
+    sim_schedule(rise_us, echo_edge, echo_arg(1));
+    sim_schedule(rise_us + (int64_t)distance_cm * ECHO_US_PER_CM, echo_edge, echo_arg(0));
+}
+
+static void on_output(int pin, int level, void *context)
+{
+    (void)context;
+    if (pin == firmware_pin_trigger) {
+        if (level == 1) {
+            plant.trigger_rise_us = sim_now_us();
+        } else if (!plant.ranging && sim_now_us() - plant.trigger_rise_us >= TRIGGER_MIN_US) {
+            start_ranging();
+        }
+    } else if (pin == firmware_pin_brake_led && level == 1 && plant.obstructed && !plant.brake_seen) {
+        plant.brake_seen = true;
+        record_latency(sim_now_us() - plant.obstructed_since_us);
+    }
+}
+
+static void obstruction_change(void *arg);
+
+static void schedule_obstruction_change(void)
+{
+    double mean_s = plant.obstructed ? options.obstruction_for_s : options.obstruction_every_s;
+    int64_t wait_us = random_exponential_us(mean_s);
+    if (plant.obstructed && wait_us < 100 * US_PER_MS) {
+        wait_us = 100 * US_PER_MS;   // Anything shorter is not a person in the zone
+    }
+    sim_schedule(sim_now_us() + wait_us, obstruction_change, NULL);
+}
+
+static void obstruction_change(void *arg)
+{
+    (void)arg;
+    plant.obstructed = !plant.obstructed;
+    if (plant.obstructed) {
+        run.obstructions++;
+        plant.obstructed_since_us = sim_now_us();
+        plant.latency_violated = false;
+        plant.brake_seen = sim_gpio_output(firmware_pin_brake_led) == 1;
+        if (plant.brake_seen) record_latency(0);
+    }
+    schedule_obstruction_change();
+}
+
+/* ===================== FAULTS ===================== */
+
+static void estop_level(void *arg)
+{
+    plant.estop_level = (int)(uintptr_t)arg;
+    sim_gpio_drive(firmware_pin_estop, plant.estop_level);
+}
+
+/* Schedules `edges` alternating levels from `start`, ending at `final_level` */
+static int64_t schedule_bounce(int64_t start_us, uint32_t edges, int final_level,
+                               int64_t min_gap_us, int64_t max_gap_us)
+{
+    int64_t at = start_us;
+    for (uint32_t i = 0; i < edges; i++) {
+        int level = ((edges - 1 - i) & 1) ? !final_level : final_level;
+        at += random_between_us(min_gap_us, max_gap_us);
+        sim_schedule(at, estop_level, (void *)(uintptr_t)level);
+    }
+    return at;
+}
+
+static void operator_press(void *arg)
+{
+    (void)arg;
+    run.estop_presses++;
+    int64_t now = sim_now_us();
+    int64_t pressed = schedule_bounce(now, 1 + 2 * (uint32_t)random_between_us(1, 6), 0, 20, 400);
+    int64_t release = pressed + random_between_us(150, 400) * US_PER_MS;
+    schedule_bounce(release, 1 + 2 * (uint32_t)random_between_us(1, 6), 1, 20, 400);
+    sim_schedule(now + random_exponential_us(options.estop_every_s), operator_press, NULL);
+}
+
+static void bounce_flood(void *arg)
+{
+    (void)arg;
+    run.bounce_floods++;
+    run.bounce_edges += options.bounce_edges;
+    uint32_t edges = options.bounce_edges | 1;   // Odd count from high: the line ends released
+    schedule_bounce(sim_now_us(), edges + 1, 1, 5, 50);
+    sim_schedule(sim_now_us() + random_exponential_us(options.bounce_every_s), bounce_flood, NULL);
+}
+
+static void stuck_end(void *arg)
+{
+    (void)arg;
+    if (sim_now_us() < plant.stuck_until_us) return;   // Extended by a later fault
+    plant.echo_generation++;
+    plant.ranging = false;
+    drive_echo(0);
+}
+
+static void stuck_start(void *arg)
+{
+    (void)arg;
+    run.stuck_faults++;
+    plant.echo_generation++;
+    plant.ranging = false;
+    plant.stuck_until_us = sim_now_us() + (int64_t)options.stuck_ms * US_PER_MS;
+    drive_echo(1);
+    sim_schedule(plant.stuck_until_us, stuck_end, NULL);
+    sim_schedule(sim_now_us() + random_exponential_us(options.stuck_every_s), stuck_start, NULL);
+}
+
+static void dropout_start(void *arg)
+{
+    (void)arg;
+    run.dropout_faults++;
+    plant.dropout_until_us = sim_now_us() + (int64_t)options.dropout_ms * US_PER_MS;
+    sim_schedule(sim_now_us() + random_exponential_us(options.dropout_every_s), dropout_start, NULL);
+}
+
+static void hog_task(void *parameters)
+{
+    (void)parameters;
+    TickType_t idle_ticks = pdMS_TO_TICKS(options.hog_period_ms - options.hog_busy_ms);
+    for (;;) {
+        sim_burn_us((int64_t)options.hog_busy_ms * US_PER_MS);
+        vTaskDelay(idle_ticks > 0 ? idle_ticks : 1);
+    }
+}
+
+/* ===================== INVARIANTS ===================== */
+
+static void report_violation(const char *invariant, const char *detail, const firmware_ride_view_t *view)
+{
+    if (run.reports++ >= options.max_reports) return;
+    printf("\nVIOLATION %s at %.6f s: %s\n", invariant, sim_now_us() / 1e6, detail);
+    printf("  published state %s, distance %d cm, obstruction_present %d; plant %s; brake %d, all-clear %d\n",
+           view->state_name, view->distance_cm, view->obstruction_present,
+           plant.obstructed ? "obstructed" : "clear",
+           sim_gpio_output(firmware_pin_brake_led), sim_gpio_output(firmware_pin_all_clear_led));
+    printf("  recent firmware output:\n");
+    sim_dump_log(stdout);
+}
+
+static void check_invariants(void *arg)
+{
+    (void)arg;
+    static bool clear_obstructed_before, outputs_bad_before;
+    int64_t now = sim_now_us();
+    firmware_ride_view_t view;
+    firmware_read_ride(&view);
+
+    run.samples++;
+    if (view.state >= 0 && view.state < MAX_STATES) run.state_samples[view.state]++;
+
+    int brake = sim_gpio_output(firmware_pin_brake_led);
+    if (plant.obstructed && !plant.latency_violated && brake == 0 &&
+        now - plant.obstructed_since_us > (int64_t)options.brake_deadline_ms * US_PER_MS) {
+        plant.latency_violated = true;
+        run.violations_latency++;
+        char detail[96];
+        snprintf(detail, sizeof(detail), "brake still off %lld ms after the obstruction appeared",
+                 (long long)((now - plant.obstructed_since_us) / US_PER_MS));
+        report_violation("brake-latency", detail, &view);
+    }
+
+    bool clear_obstructed = view.all_clear && view.obstruction_present;
+    if (clear_obstructed && !clear_obstructed_before) {
+        run.violations_clear_obstructed++;
+        report_violation("clear-obstructed", "ALL_CLEAR published with an obstruction reading", &view);
+    }
+    clear_obstructed_before = clear_obstructed;
+
+    bool outputs_bad = brake == sim_gpio_output(firmware_pin_all_clear_led);
+    if (outputs_bad && !outputs_bad_before) {
+        run.violations_outputs++;
+        report_violation("outputs", "brake and all-clear outputs agree", &view);
+    }
+    outputs_bad_before = outputs_bad;
+
+    sim_schedule(now + options.check_us, check_invariants, NULL);
+}
+
+/* ===================== REPORT ===================== */
+
+static int compare_i64(const void *a, const void *b)
+{
+    int64_t x = *(const int64_t *)a, y = *(const int64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static double latency_percentile_ms(double q)
+{
+    if (run.latency_count == 0) return 0.0;
+    size_t rank = (size_t)(q * run.latency_count + 0.999999);
+    if (rank < 1) rank = 1;
+    if (rank > run.latency_count) rank = run.latency_count;
+    return run.latencies_us[rank - 1] / 1000.0;
+}
+
+static double wall_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* ===================== OPTIONS ===================== */
+
+static void usage(const char *program)
+{
+    fprintf(stderr, "usage: %s [--hours H] [--seed N] [--brake-deadline-ms X] [--no-faults]\n"
+                    "  [--bounce-every-s S] [--bounce-edges N] [--stuck-every-s S] [--stuck-ms MS]\n"
+                    "  [--dropout-every-s S] [--dropout-ms MS] [--hogs N] [--hog-priority P]\n"
+                    "  [--hog-busy-ms MS] [--hog-period-ms MS] [--obstruction-every-s S]\n"
+                    "  [--obstruction-for-s S] [--estop-every-s S] [-v]\n", program);
+    exit(2);
+}
+
+static void parse_options(int argc, char **argv)
+{
+    static const struct {
+        const char *name;
+        double *real;
+        uint32_t *whole;
+    } table[] = {
+        { "--hours", &options.hours, NULL },
+        { "--seed", NULL, &options.seed },
+        { "--brake-deadline-ms", NULL, &options.brake_deadline_ms },
+        { "--bounce-every-s", &options.bounce_every_s, NULL },
+        { "--bounce-edges", NULL, &options.bounce_edges },
+        { "--stuck-every-s", &options.stuck_every_s, NULL },
+        { "--stuck-ms", NULL, &options.stuck_ms },
+        { "--dropout-every-s", &options.dropout_every_s, NULL },
+        { "--dropout-ms", NULL, &options.dropout_ms },
+        { "--hogs", NULL, &options.hogs },
+        { "--hog-priority", NULL, &options.hog_priority },
+        { "--hog-busy-ms", NULL, &options.hog_busy_ms },
+        { "--hog-period-ms", NULL, &options.hog_period_ms },
+        { "--obstruction-every-s", &options.obstruction_every_s, NULL },
+        { "--obstruction-for-s", &options.obstruction_for_s, NULL },
+        { "--estop-every-s", &options.estop_every_s, NULL },
+    };
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-v") == 0) {
+            options.verbose = true;
+            continue;
+        }
+        if (strcmp(argv[i], "--no-faults") == 0) {
+            options.bounce_every_s = options.stuck_every_s = options.dropout_every_s = 0;
+            options.hogs = 0;
+            continue;
+        }
+        size_t k = 0;
+        while (k < sizeof(table) / sizeof(table[0]) && strcmp(argv[i], table[k].name) != 0) k++;
+        if (k == sizeof(table) / sizeof(table[0]) || i + 1 == argc) usage(argv[0]);
+        double value = strtod(argv[++i], NULL);
+        if (table[k].real) {
+            *table[k].real = value;
+        } else {
+            *table[k].whole = (uint32_t)value;
+        }
+    }
+    if (options.hours <= 0 || options.obstruction_every_s <= 0 || options.obstruction_for_s <= 0 ||
+        options.hog_busy_ms > options.hog_period_ms || options.hog_priority >= configMAX_PRIORITIES) {
+        usage(argv[0]);
+    }
+}
+
+/* ===================== MAIN ===================== */
+
+int main(int argc, char **argv)
+{
+    parse_options(argc, argv);
+    rng_state = 0x9E3779B97F4A7C15ULL ^ ((uint64_t)options.seed << 1) ^ 1;
+    sim_set_verbose(options.verbose);
+
+    sim_init();
+    sim_set_output_hook(on_output, NULL);
+    sim_gpio_drive(firmware_pin_estop, 1);   // E-Stop released, echo idle
+    drive_echo(0);
+    app_main();
+
+    for (uint32_t i = 0; i < options.hogs; i++) {
+        xTaskCreate(hog_task, "Hog", 2048, NULL, options.hog_priority, NULL);
+    }
+
+    schedule_obstruction_change();
+    if (options.estop_every_s > 0) sim_schedule(random_exponential_us(options.estop_every_s), operator_press, NULL);
+    if (options.bounce_every_s > 0) sim_schedule(random_exponential_us(options.bounce_every_s), bounce_flood, NULL);
+    if (options.stuck_every_s > 0) sim_schedule(random_exponential_us(options.stuck_every_s), stuck_start, NULL);
+    if (options.dropout_every_s > 0) sim_schedule(random_exponential_us(options.dropout_every_s), dropout_start, NULL);
+    sim_schedule(options.check_us, check_invariants, NULL);
+
+    printf("RIDE STRESS: %.2f simulated hours, seed %u, brake deadline %u ms\n",
+           options.hours, options.seed, options.brake_deadline_ms);
+    printf("  faults: bounce flood %u edges every %.0f s, echo stuck %u ms every %.0f s, "
+           "dropout %u ms every %.0f s, %u hog(s) at priority %u (%u of every %u ms)\n",
+           options.bounce_edges, options.bounce_every_s, options.stuck_ms, options.stuck_every_s,
+           options.dropout_ms, options.dropout_every_s, options.hogs, options.hog_priority,
+           options.hog_busy_ms, options.hog_period_ms);
+
+    int64_t end_us = (int64_t)(options.hours * 3600.0 * US_PER_S);
+    double wall_start = wall_seconds();
+    for (int64_t until = 0; until < end_us;) {
+        until = until + 3600 * US_PER_S < end_us ? until + 3600 * US_PER_S : end_us;
+        sim_run_until(until);
+        printf("  %8.1f s simulated, %.2f s wall, violations so far %llu\n", until / 1e6,
+               wall_seconds() - wall_start,
+               (unsigned long long)(run.violations_latency + run.violations_clear_obstructed +
+                                    run.violations_outputs));
+    }
+    double wall_s = wall_seconds() - wall_start;
+
+    const sim_stats_t *stats = sim_get_stats();
+    uint64_t events = stats->events - run.samples;   // Invariant sampling is the harness, not the system
+    double sim_s = end_us / 1e6;
+    uint64_t violations = run.violations_latency + run.violations_clear_obstructed + run.violations_outputs;
+    qsort(run.latencies_us, run.latency_count, sizeof(int64_t), compare_i64);
+
+    printf("\nThroughput: %.1f s simulated in %.2f s wall (%.0fx real time), "
+           "%llu events, %.2f M events/s\n",
+           sim_s, wall_s, sim_s / wall_s, (unsigned long long)events, events / wall_s / 1e6);
+    printf("  ticks %llu, context switches %llu, ISRs %llu, esp_timer callbacks %llu\n",
+           (unsigned long long)stats->ticks, (unsigned long long)stats->context_switches,
+           (unsigned long long)stats->isr_runs, (unsigned long long)stats->timer_callbacks);
+    printf("Plant: %llu obstructions, %llu measurements (%llu blind), %llu operator E-Stops\n",
+           (unsigned long long)run.obstructions, (unsigned long long)run.measurements,
+           (unsigned long long)run.blind_measurements, (unsigned long long)run.estop_presses);
+    printf("Faults: %llu bounce floods (%llu edges), %llu echo stuck high, %llu dropouts\n",
+           (unsigned long long)run.bounce_floods, (unsigned long long)run.bounce_edges,
+           (unsigned long long)run.stuck_faults, (unsigned long long)run.dropout_faults);
+    printf("Brake latency after obstruction: p50 %.1f ms, p99 %.1f ms, max %.1f ms (deadline %u ms)\n",
+           latency_percentile_ms(0.50), latency_percentile_ms(0.99), latency_percentile_ms(1.0),
+           options.brake_deadline_ms);
+    printf("Ride: %lu transitions; time in state:", (unsigned long)firmware_transition_count());
+    for (int s = 0; s < firmware_state_count && s < MAX_STATES; s++) {
+        printf(" %s %.1f%%", firmware_state_name(s),
+               run.samples ? 100.0 * run.state_samples[s] / run.samples : 0.0);
+    }
+    printf("\nSupervisor: %s; task watchdog timeouts %u (longest feed gap %.1f ms, idle starved %.1f ms)\n",
+           supervisor_faulted() ? "LIVENESS FAULT LATCHED" : "all tasks live",
+           stats->wdt_timeouts, stats->wdt_max_gap_us / 1000.0, stats->idle_max_gap_us / 1000.0);
+    sim_print_tasks(stdout);
+    printf("Invariants: brake-latency %llu, clear-obstructed %llu, outputs %llu -> %s\n",
+           (unsigned long long)run.violations_latency, (unsigned long long)run.violations_clear_obstructed,
+           (unsigned long long)run.violations_outputs, violations ? "FAIL" : "PASS");
+    printf("STRESS {\"seed\":%u,\"sim_s\":%.1f,\"wall_s\":%.3f,\"events\":%llu,\"events_per_s\":%.0f,"
+           "\"obstructions\":%llu,\"brake_p99_ms\":%.1f,\"brake_max_ms\":%.1f,\"liveness_fault\":%s,"
+           "\"wdt_timeouts\":%u,\"violations\":%llu,\"pass\":%s}\n",
+           options.seed, sim_s, wall_s, (unsigned long long)events, events / wall_s,
+           (unsigned long long)run.obstructions, latency_percentile_ms(0.99), latency_percentile_ms(1.0),
+           supervisor_faulted() ? "true" : "false", stats->wdt_timeouts,
+           (unsigned long long)violations, violations ? "false" : "true");
+    return violations ? 1 : 0;
+}
@@ -0,0 +1,11 @@
+/***********************************************************************
+ * Host simulation: ROM busy-wait - see sim_kernel.c
+ ***********************************************************************/
+#ifndef SIM_ETS_SYS_H
+#define SIM_ETS_SYS_H
+
+#include <stdint.h>
+
+void ets_delay_us(uint32_t us);
+
+#endif /* SIM_ETS_SYS_H */
@@ -0,0 +1,803 @@
+/***********************************************************************
+ * Host Simulation Kernel - see sim_kernel.h
+ ***********************************************************************/
+#define _XOPEN_SOURCE 700
+#define SIM_HARNESS
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ucontext.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "driver/gpio.h"
+#include "esp_timer.h"
+#include "esp_task_wdt.h"
+#include "rom/ets_sys.h"
+#include "sim_kernel.h"
+
+#define SIM_TICK_US             (1000000 / configTICK_RATE_HZ)
+#define SIM_MAX_TASKS           16
+#define SIM_MAX_TIMERS          8
+#define SIM_MAX_SEMAPHORES      16
+#define SIM_MAX_WDT_USERS       4
+#define SIM_TASK_STACK_BYTES    (256 * 1024)    // Host printf needs far more than the target stacks
+#define SIM_GPIO_COUNT          40
+#define SIM_LOG_LINES           32
+#define SIM_LOG_LINE_BYTES      160
+
+/* ===================== STATE ===================== */
+
+typedef enum {
+    TASK_READY,
+    TASK_BLOCKED,
+    TASK_DELETED,
+} task_state_t;
+
+struct sim_task {
+    ucontext_t context;
+    void *stack;
+    const char *name;
+    UBaseType_t priority;
+    TaskFunction_t function;
+    void *parameters;
+    task_state_t state;
+    uint64_t ready_order;               // FIFO position among equal priorities
+    uint32_t wait_generation;           // Invalidates a pending timeout once woken another way
+    struct sim_semaphore *waiting_on;
+    bool got_semaphore;
+    bool wdt_subscribed;
+    int64_t wdt_last_reset_us;
+    int64_t cpu_us;
+};
+
+struct sim_semaphore {
+    UBaseType_t count;
+    UBaseType_t max;
+};
+
+struct sim_esp_timer {
+    esp_timer_cb_t callback;
+    void *arg;
+    int64_t period_us;
+    int64_t next_us;
+    uint32_t generation;                // Invalidates a pending expiry once stopped or restarted
+    uint32_t pending;                   // Expiries not yet dispatched by the esp_timer task
+};
+
+struct sim_wdt_user {
+    const char *name;
+    bool active;
+    int64_t last_reset_us;
+};
+
+typedef void (*kernel_handler_t)(void *arg, uint32_t tag);
+
+typedef struct {
+    int64_t at_us;
+    uint64_t order;                     // Keeps same-time events in scheduling order
+    kernel_handler_t handler;           // Kernel events...
+    sim_event_fn_t fn;                  // ...or harness events
+    void *arg;
+    uint32_t tag;
+} event_t;
+
+typedef struct {
+    gpio_mode_t mode;
+    bool pull_up;
+    gpio_int_type_t intr_type;
+    gpio_isr_t isr;
+    void *isr_arg;
+    int out_level;
+    int in_level;
+    bool driven;                        // in_level set by the harness; otherwise the pull decides
+} pin_t;
+
+static int64_t now_us;
+static int64_t stolen_us;               // ISR time charged to whatever runs next
+static int64_t run_end_us;
+static uint64_t event_order;
+static uint64_t ready_order;
+static int event_depth;                 // Non-zero while interrupt-context events run
+
+static event_t *events;
+static size_t event_count, event_capacity;
+
+static struct sim_task tasks[SIM_MAX_TASKS];
+static int task_count;
+static struct sim_task *current;
+static struct sim_task *last_run;
+static struct sim_task *timer_task;
+static ucontext_t scheduler_context;
+static bool reschedule_pending;         // A tick, a yielding ISR or a give may have readied a better task
+static bool time_slice_expired;
+static int64_t run_since_us;
+static int64_t last_idle_us;
+
+static struct sim_semaphore semaphores[SIM_MAX_SEMAPHORES];
+static int semaphore_count;
+static struct sim_esp_timer timers[SIM_MAX_TIMERS];
+static int timer_count;
+static struct sim_wdt_user wdt_users[SIM_MAX_WDT_USERS];
+
+static pin_t pins[SIM_GPIO_COUNT];
+static bool isr_service_installed;
+static sim_output_hook_t output_hook;
+static void *output_hook_context;
+
+static sim_stats_t stats;
+static bool verbose;
+static char log_ring[SIM_LOG_LINES][SIM_LOG_LINE_BYTES];
+static uint32_t log_head;
+
+/* ===================== EVENT QUEUE ===================== */
+
+static bool event_before(const event_t *a, const event_t *b)
+{
+    return a->at_us < b->at_us || (a->at_us == b->at_us && a->order < b->order);
+}
+
+static void push_event(int64_t at_us, kernel_handler_t handler, sim_event_fn_t fn, void *arg, uint32_t tag)
+{
+    if (event_count == event_capacity) {
+        event_capacity = event_capacity ? event_capacity * 2 : 256;
+        events = realloc(events, event_capacity * sizeof(event_t));
+        if (events == NULL) {
+            fprintf(stderr, "sim: out of memory for events\n");
+            exit(2);
+        }
+    }
+    event_t e = { at_us, event_order++, handler, fn, arg, tag };
+    size_t i = event_count++;
+    while (i > 0 && event_before(&e, &events[(i - 1) / 2])) {
+        events[i] = events[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    events[i] = e;
+}
+
+static event_t pop_event(void)
+{
+    event_t top = events[0];
+    event_t last = events[--event_count];
+    size_t i = 0;
+    for (;;) {
+        size_t child = 2 * i + 1;
+        if (child >= event_count) break;
+        if (child + 1 < event_count && event_before(&events[child + 1], &events[child])) child++;
+        if (!event_before(&events[child], &last)) break;
+        events[i] = events[child];
+        i = child;
+    }
+    if (event_count > 0) events[i] = last;
+    return top;
+}
+
+/* Runs every event due by `until`, in interrupt context */
+static void run_due_events(int64_t until)
+{
+    event_depth++;
+    while (event_count > 0 && events[0].at_us <= until) {
+        event_t e = pop_event();
+        if (e.at_us > now_us) now_us = e.at_us;
+        stats.events++;
+        if (e.handler != NULL) {
+            e.handler(e.arg, e.tag);
+        } else {
+            e.fn(e.arg);
+        }
+    }
+    event_depth--;
+}
+
+/* ===================== SCHEDULER ===================== */
+
+static int priority_of(const struct sim_task *task)
+{
+    return task ? (int)task->priority : -1;
+}
+
+/* Highest-priority ready task other than `except`, FIFO among equals */
+static struct sim_task *best_ready(const struct sim_task *except)
+{
+    struct sim_task *best = NULL;
+    for (int i = 0; i < task_count; i++) {
+        struct sim_task *t = &tasks[i];
+        if (t == except || t->state != TASK_READY) continue;
+        if (best == NULL || t->priority > best->priority ||
+            (t->priority == best->priority && t->ready_order < best->ready_order)) {
+            best = t;
+        }
+    }
+    return best;
+}
+
+static void make_ready(struct sim_task *task)
+{
+    task->state = TASK_READY;
+    task->ready_order = ++ready_order;
+    task->wait_generation++;
+}
+
+static void switch_to_scheduler(void)
+{
+    struct sim_task *self = current;
+    swapcontext(&self->context, &scheduler_context);
+}
+
+static void block_current(void)
+{
+    current->state = TASK_BLOCKED;
+    switch_to_scheduler();
+}
+
+/* Called by running task code after time has passed or something was readied */
+static void maybe_preempt(void)
+{
+    if (current == NULL || event_depth > 0) return;
+
+    if (now_us >= run_end_us) {
+        switch_to_scheduler();   // Stays ready; resumes on the next sim_run_until()
+        return;
+    }
+    if (!reschedule_pending) return;
+    reschedule_pending = false;
+
+    struct sim_task *best = best_ready(current);
+    bool slice = time_slice_expired;
+    time_slice_expired = false;
+    if (best == NULL) return;
+    if (best->priority > current->priority || (slice && best->priority == current->priority)) {
+        if (slice && best->priority == current->priority) {
+            current->ready_order = ++ready_order;   // Round robin: to the back of its priority
+        }
+        switch_to_scheduler();
+    }
+}
+
+/* Spends simulated CPU time in the current context */
+static void advance(int64_t us)
+{
+    if (event_depth > 0) {
+        stolen_us += us;   // Inside an ISR: charged to the interrupted code afterwards
+        return;
+    }
+    int64_t target = now_us + us;
+    for (;;) {
+        run_due_events(target);
+        if (stolen_us == 0) break;
+        target += stolen_us;
+        stolen_us = 0;
+    }
+    now_us = target;
+    maybe_preempt();
+}
+
+static void task_entry(void)
+{
+    current->function(current->parameters);
+    current->state = TASK_DELETED;   // A task function returned: treated as vTaskDelete(NULL)
+    switch_to_scheduler();
+}
+
+static void tick_handler(void *arg, uint32_t tag)
+{
+    (void)arg;
+    (void)tag;
+    stats.ticks++;
+    reschedule_pending = true;
+    time_slice_expired = true;
+
+    for (int i = 0; i < task_count; i++) {
+        struct sim_task *t = &tasks[i];
+        if (!t->wdt_subscribed || t->state == TASK_DELETED) continue;
+        int64_t gap = now_us - t->wdt_last_reset_us;
+        if (gap > stats.wdt_max_gap_us) stats.wdt_max_gap_us = gap;
+        if (gap > SIM_WDT_TIMEOUT_US) {
+            stats.wdt_timeouts++;
+            sim_printf("task_wdt: %s did not reset the watchdog in time\n", t->name);
+            t->wdt_last_reset_us = now_us;   // Re-armed, like the target's repeated reports
+        }
+    }
+    for (int i = 0; i < SIM_MAX_WDT_USERS; i++) {
+        struct sim_wdt_user *u = &wdt_users[i];
+        if (!u->active) continue;
+        int64_t gap = now_us - u->last_reset_us;
+        if (gap > stats.wdt_max_gap_us) stats.wdt_max_gap_us = gap;
+        if (gap > SIM_WDT_TIMEOUT_US) {
+            stats.wdt_timeouts++;
+            sim_printf("task_wdt: user %s did not reset the watchdog in time\n", u->name);
+            u->last_reset_us = now_us;
+        }
+    }
+    int64_t idle_gap = now_us - last_idle_us;
+    if (idle_gap > stats.idle_max_gap_us) stats.idle_max_gap_us = idle_gap;
+    if (idle_gap > SIM_WDT_TIMEOUT_US) {
+        stats.wdt_timeouts++;
+        sim_printf("task_wdt: IDLE starved\n");
+        last_idle_us = now_us;
+    }
+    push_event(now_us + SIM_TICK_US, tick_handler, NULL, NULL, 0);
+}
+
+static void timeout_handler(void *arg, uint32_t generation)
+{
+    struct sim_task *task = arg;
+    if (task->state != TASK_BLOCKED || task->wait_generation != generation) return;
+    task->waiting_on = NULL;
+    make_ready(task);   // Delays and timeouts expire on tick boundaries, where the tick yields
+}
+
+static void esp_timer_task(void *parameters)
+{
+    (void)parameters;
+    for (;;) {
+        bool dispatched = false;
+        for (int i = 0; i < timer_count; i++) {
+            while (timers[i].pending > 0) {
+                timers[i].pending--;
+                stats.timer_callbacks++;
+                timers[i].callback(timers[i].arg);
+                dispatched = true;
+            }
+        }
+        if (!dispatched) {
+            block_current();   // Readied by the next expiry
+        }
+    }
+}
+
+void sim_init(void)
+{
+    now_us = 0;
+    stolen_us = 0;
+    last_idle_us = 0;
+    memset(&stats, 0, sizeof(stats));
+    push_event(SIM_TICK_US, tick_handler, NULL, NULL, 0);
+    xTaskCreate(esp_timer_task, "esp_timer", 4096, NULL, SIM_ESP_TIMER_PRIORITY, &timer_task);
+}
+
+void sim_run_until(int64_t end_us)
+{
+    run_end_us = end_us;
+    while (now_us < end_us) {
+        struct sim_task *next = best_ready(NULL);
+        if (next == NULL) {
+            /* Idle: jump straight to the next event */
+            last_idle_us = now_us;
+            if (event_count == 0 || events[0].at_us > end_us) {
+                now_us = end_us;
+                break;
+            }
+            now_us = events[0].at_us;
+            run_due_events(now_us);
+            stolen_us = 0;
+            reschedule_pending = false;
+            time_slice_expired = false;
+            last_idle_us = now_us;
+            continue;
+        }
+
+        if (next != last_run) {
+            stats.context_switches++;
+            stats.events++;
+            last_run = next;
+        }
+        current = next;
+        run_since_us = now_us;
+        swapcontext(&scheduler_context, &next->context);
+        current->cpu_us += now_us - run_since_us;
+        current = NULL;
+    }
+}
+
+/* ===================== TASK API ===================== */
+
+BaseType_t xTaskCreate(TaskFunction_t function, const char *name, uint32_t stack_depth,
+                       void *parameters, UBaseType_t priority, TaskHandle_t *created)
+{
+    (void)stack_depth;   // Host stacks are SIM_TASK_STACK_BYTES
+    if (task_count == SIM_MAX_TASKS) return pdFAIL;
+    struct sim_task *task = &tasks[task_count++];
+
+    memset(task, 0, sizeof(*task));
+    task->name = name;
+    task->priority = priority;
+    task->function = function;
+    task->parameters = parameters;
+    task->stack = malloc(SIM_TASK_STACK_BYTES);
+    if (task->stack == NULL) return pdFAIL;
+
+    getcontext(&task->context);
+    task->context.uc_stack.ss_sp = task->stack;
+    task->context.uc_stack.ss_size = SIM_TASK_STACK_BYTES;
+    task->context.uc_link = NULL;
+    makecontext(&task->context, task_entry, 0);
+    make_ready(task);
+
+    if (created != NULL) *created = task;
+    if (current != NULL && priority > current->priority) {
+        reschedule_pending = true;
+        maybe_preempt();
+    }
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    if (task == NULL || task == current) {
+        current->state = TASK_DELETED;
+        switch_to_scheduler();
+    } else {
+        task->state = TASK_DELETED;
+    }
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    if (ticks == 0) {
+        current->ready_order = ++ready_order;
+        reschedule_pending = true;
+        time_slice_expired = true;
+        maybe_preempt();
+        return;
+    }
+    int64_t wake_us = (now_us / SIM_TICK_US + ticks) * SIM_TICK_US;
+    push_event(wake_us, timeout_handler, NULL, current, current->wait_generation);
+    block_current();
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)(now_us / SIM_TICK_US);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return current;
+}
+
+/* ===================== SEMAPHORES ===================== */
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    if (semaphore_count == SIM_MAX_SEMAPHORES) return NULL;
+    struct sim_semaphore *s = &semaphores[semaphore_count++];
+    s->count = 0;
+    s->max = 1;
+    return s;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks)
+{
+    if (semaphore->count > 0) {
+        semaphore->count--;
+        return pdTRUE;
+    }
+    if (ticks == 0) return pdFALSE;
+
+    current->waiting_on = semaphore;
+    current->got_semaphore = false;
+    if (ticks != portMAX_DELAY) {
+        int64_t wake_us = (now_us / SIM_TICK_US + ticks) * SIM_TICK_US;
+        push_event(wake_us, timeout_handler, NULL, current, current->wait_generation);
+    }
+    block_current();
+    return current->got_semaphore ? pdTRUE : pdFALSE;
+}
+
+/* Hands the semaphore to its best waiter, or counts it. Returns the woken task. */
+static struct sim_task *give(SemaphoreHandle_t semaphore, BaseType_t *given)
+{
+    struct sim_task *waiter = NULL;
+    for (int i = 0; i < task_count; i++) {
+        struct sim_task *t = &tasks[i];
+        if (t->state != TASK_BLOCKED || t->waiting_on != semaphore) continue;
+        if (waiter == NULL || t->priority > waiter->priority) waiter = t;
+    }
+    if (waiter != NULL) {
+        waiter->waiting_on = NULL;
+        waiter->got_semaphore = true;
+        make_ready(waiter);
+        *given = pdTRUE;
+    } else if (semaphore->count < semaphore->max) {
+        semaphore->count++;
+        *given = pdTRUE;
+    } else {
+        *given = pdFALSE;
+    }
+    return waiter;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+    BaseType_t given;
+    struct sim_task *woken = give(semaphore, &given);
+    if (woken != NULL && priority_of(woken) > priority_of(current)) {
+        reschedule_pending = true;
+        maybe_preempt();
+    }
+    return given;
+}
+
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t semaphore, BaseType_t *higher_priority_task_woken)
+{
+    BaseType_t given;
+    struct sim_task *woken = give(semaphore, &given);
+    if (higher_priority_task_woken != NULL && woken != NULL &&
+        priority_of(woken) > priority_of(current)) {
+        *higher_priority_task_woken = pdTRUE;
+    }
+    return given;
+}
+
+void sim_yield_from_isr(void)
+{
+    reschedule_pending = true;   // Acted on when the interrupted code resumes
+}
+
+/* ===================== ESP_TIMER ===================== */
+
+int64_t esp_timer_get_time(void)
+{
+    advance(SIM_TIMER_READ_COST_US);
+    return now_us;
+}
+
+static void timer_expiry_handler(void *arg, uint32_t generation)
+{
+    struct sim_esp_timer *timer = arg;
+    if (timer->generation != generation) return;
+
+    timer->pending++;
+    timer->next_us += timer->period_us;
+    push_event(timer->next_us, timer_expiry_handler, NULL, timer, generation);
+
+    if (timer_task->state == TASK_BLOCKED) {
+        make_ready(timer_task);
+    }
+    reschedule_pending = true;   // The esp_timer ISR yields to its task
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *args, esp_timer_handle_t *out)
+{
+    if (timer_count == SIM_MAX_TIMERS) return ESP_ERR_NO_MEM;
+    struct sim_esp_timer *timer = &timers[timer_count++];
+    memset(timer, 0, sizeof(*timer));
+    timer->callback = args->callback;
+    timer->arg = args->arg;
+    *out = timer;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period_us)
+{
+    timer->generation++;
+    timer->period_us = (int64_t)period_us;
+    timer->next_us = now_us + timer->period_us;
+    push_event(timer->next_us, timer_expiry_handler, NULL, timer, timer->generation);
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer)
+{
+    timer->generation++;
+    timer->pending = 0;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer)
+{
+    return esp_timer_stop(timer);   // Slots are not reused
+}
+
+/* ===================== TASK WATCHDOG ===================== */
+
+esp_err_t esp_task_wdt_add(TaskHandle_t task)
+{
+    if (task == NULL) task = current;
+    if (task == NULL || task->wdt_subscribed) return ESP_ERR_INVALID_ARG;
+    task->wdt_subscribed = true;
+    task->wdt_last_reset_us = now_us;
+    return ESP_OK;
+}
+
+esp_err_t esp_task_wdt_reset(void)
+{
+    if (current == NULL || !current->wdt_subscribed) return ESP_ERR_INVALID_STATE;
+    current->wdt_last_reset_us = now_us;
+    return ESP_OK;
+}
+
+esp_err_t esp_task_wdt_add_user(const char *name, esp_task_wdt_user_handle_t *user)
+{
+    for (int i = 0; i < SIM_MAX_WDT_USERS; i++) {
+        if (!wdt_users[i].active) {
+            wdt_users[i] = (struct sim_wdt_user){ .name = name, .active = true, .last_reset_us = now_us };
+            *user = &wdt_users[i];
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_NO_MEM;
+}
+
+esp_err_t esp_task_wdt_reset_user(esp_task_wdt_user_handle_t user)
+{
+    if (user == NULL || !user->active) return ESP_ERR_INVALID_ARG;
+    user->last_reset_us = now_us;
+    return ESP_OK;
+}
+
+esp_err_t esp_task_wdt_delete_user(esp_task_wdt_user_handle_t user)
+{
+    if (user == NULL || !user->active) return ESP_ERR_INVALID_ARG;
+    user->active = false;
+    return ESP_OK;
+}
+
+/* ===================== ROM ===================== */
+
+void ets_delay_us(uint32_t us)
+{
+    advance(us);
+}
+
+/* ===================== GPIO ===================== */
+
+static int input_level(const pin_t *pin)
+{
+    if (pin->driven) return pin->in_level;
+    return pin->pull_up ? 1 : 0;
+}
+
+esp_err_t gpio_config(const gpio_config_t *config)
+{
+    for (int i = 0; i < SIM_GPIO_COUNT; i++) {
+        if ((config->pin_bit_mask & (1ULL << i)) == 0) continue;
+        pins[i].mode = config->mode;
+        pins[i].pull_up = config->pull_up_en == GPIO_PULLUP_ENABLE;
+        pins[i].intr_type = config->intr_type;
+    }
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_direction(gpio_num_t pin, gpio_mode_t mode)
+{
+    if (pin < 0 || pin >= SIM_GPIO_COUNT) return ESP_ERR_INVALID_ARG;
+    pins[pin].mode = mode;
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_level(gpio_num_t pin, uint32_t level)
+{
+    if (pin < 0 || pin >= SIM_GPIO_COUNT) return ESP_ERR_INVALID_ARG;
+    int new_level = level ? 1 : 0;
+    if (pins[pin].out_level != new_level) {
+        pins[pin].out_level = new_level;
+        if (output_hook != NULL) output_hook(pin, new_level, output_hook_context);
+    }
+    return ESP_OK;
+}
+
+int gpio_get_level(gpio_num_t pin)
+{
+    if (pin < 0 || pin >= SIM_GPIO_COUNT) return 0;
+    return input_level(&pins[pin]);
+}
+
+esp_err_t gpio_install_isr_service(int flags)
+{
+    (void)flags;
+    isr_service_installed = true;
+    return ESP_OK;
+}
+
+esp_err_t gpio_isr_handler_add(gpio_num_t pin, gpio_isr_t handler, void *arg)
+{
+    if (!isr_service_installed) return ESP_ERR_INVALID_STATE;
+    pins[pin].isr = handler;
+    pins[pin].isr_arg = arg;
+    return ESP_OK;
+}
+
+/* ===================== HARNESS API ===================== */
+
+int64_t sim_now_us(void)
+{
+    return now_us;
+}
+
+void sim_schedule(int64_t at_us, sim_event_fn_t fn, void *arg)
+{
+    push_event(at_us < now_us ? now_us : at_us, NULL, fn, arg, 0);
+}
+
+void sim_gpio_drive(int pin_number, int level)
+{
+    pin_t *pin = &pins[pin_number];
+    int before = input_level(pin);
+    pin->driven = true;
+    pin->in_level = level ? 1 : 0;
+    int after = input_level(pin);
+    if (before == after || pin->isr == NULL) return;
+
+    bool fire = pin->intr_type == GPIO_INTR_ANYEDGE ||
+                (pin->intr_type == GPIO_INTR_POSEDGE && after == 1) ||
+                (pin->intr_type == GPIO_INTR_NEGEDGE && after == 0);
+    if (!fire) return;
+
+    stats.isr_runs++;
+    stolen_us += SIM_ISR_COST_US;
+    event_depth++;
+    pin->isr(pin->isr_arg);
+    event_depth--;
+}
+
+int sim_gpio_output(int pin)
+{
+    return pins[pin].out_level;
+}
+
+void sim_set_output_hook(sim_output_hook_t hook, void *context)
+{
+    output_hook = hook;
+    output_hook_context = context;
+}
+
+void sim_burn_us(int64_t us)
+{
+    /* In slices, so ticks and ISRs interleave as they would with real code */
+    while (us > 0) {
+        int64_t slice = us < 100 ? us : 100;
+        advance(slice);
+        us -= slice;
+    }
+}
+
+const sim_stats_t *sim_get_stats(void)
+{
+    return &stats;
+}
+
+void sim_print_tasks(FILE *out)
+{
+    fprintf(out, "  %-16s %4s %8s\n", "task", "prio", "cpu %");
+    for (int i = 0; i < task_count; i++) {
+        const struct sim_task *t = &tasks[i];
+        fprintf(out, "  %-16s %4u %8.3f\n", t->name, t->priority,
+                now_us > 0 ? 100.0 * t->cpu_us / now_us : 0.0);
+    }
+}
+
+/* ===================== CONSOLE ===================== */
+
+void sim_set_verbose(bool enabled)
+{
+    verbose = enabled;
+}
+
+int sim_printf(const char *format, ...)
+{
+    char text[SIM_LOG_LINE_BYTES - 16];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+
+    size_t end = strlen(text);
+    while (end > 0 && text[end - 1] == '\n') text[--end] = '\0';
+
+    snprintf(log_ring[log_head % SIM_LOG_LINES], SIM_LOG_LINE_BYTES, "[%11.6f] %s",
+             now_us / 1e6, text);
+    if (verbose) printf("%s\n", log_ring[log_head % SIM_LOG_LINES]);
+    log_head++;
+    return length;
+}
+
+void sim_dump_log(FILE *out)
+{
+    uint32_t first = log_head > SIM_LOG_LINES ? log_head - SIM_LOG_LINES : 0;
+    for (uint32_t i = first; i < log_head; i++) {
+        fprintf(out, "    %s\n", log_ring[i % SIM_LOG_LINES]);
+    }
+}
@@ -0,0 +1,79 @@
+/***********************************************************************
+ * Host Simulation Kernel - harness side
+ * A deterministic, single-core, discrete-event stand-in for the parts
+ * of FreeRTOS and ESP-IDF the ride firmware uses, so main.c can run
+ * unmodified on the host far faster than real time:
+ *   - tasks are ucontext coroutines scheduled by priority, with
+ *     FreeRTOS semantics: preemption on ticks, on gives and on ISRs
+ *     that yield, time slicing between equal priorities each tick,
+ *   - simulated time only moves when code spends it: busy waits
+ *     (ets_delay_us), clock reads (esp_timer_get_time), ISR entry and
+ *     harness CPU burns; everything else takes zero time,
+ *   - esp_timer callbacks run on an "esp_timer" task at priority 22,
+ *   - the task watchdog is checked every tick, including idle
+ *     starvation, and timeouts are counted rather than fatal.
+ *
+ * The harness (ride_stress.c) drives input pins, observes output pins
+ * and schedules its own events on the same clock.
+ ***********************************************************************/
+#ifndef SIM_KERNEL_H
+#define SIM_KERNEL_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#define SIM_TIMER_READ_COST_US  1           // esp_timer_get_time(); paces polling loops
+#define SIM_ISR_COST_US         2           // Entry, handler and exit of one GPIO interrupt
+#define SIM_WDT_TIMEOUT_US      5000000     // CONFIG_ESP_TASK_WDT_TIMEOUT_S default
+#define SIM_ESP_TIMER_PRIORITY  22          // ESP-IDF esp_timer task priority
+
+typedef void (*sim_event_fn_t)(void *arg);
+typedef void (*sim_output_hook_t)(int pin, int level, void *context);
+
+typedef struct {
+    uint64_t events;            // Everything processed: ticks, ISRs, timer expiries, wake-ups, harness events, switches
+    uint64_t context_switches;
+    uint64_t ticks;
+    uint64_t isr_runs;
+    uint64_t timer_callbacks;
+    uint32_t wdt_timeouts;      // Watchdog periods missed by a subscribed task, a user or idle
+    int64_t wdt_max_gap_us;     // Longest gap between resets of a subscribed task or user
+    int64_t idle_max_gap_us;    // Longest time the idle task was starved
+} sim_stats_t;
+
+/* Resets the clock and creates the esp_timer task. Call before app_main(). */
+void sim_init(void);
+
+int64_t sim_now_us(void);
+
+/* Runs fn(arg) at the given simulated time, in interrupt context: it must not block. */
+void sim_schedule(int64_t at_us, sim_event_fn_t fn, void *arg);
+
+/* Drives an input pin from outside; an edge runs the pin's ISR immediately. */
+void sim_gpio_drive(int pin, int level);
+
+/* Last level the firmware wrote to an output pin. */
+int sim_gpio_output(int pin);
+
+/* Called on every change of an output pin, from the writing task. */
+void sim_set_output_hook(sim_output_hook_t hook, void *context);
+
+/* Spends CPU time in the calling task, preemptible like real code. */
+void sim_burn_us(int64_t us);
+
+/* Runs the scheduler until the clock reaches end_us. */
+void sim_run_until(int64_t end_us);
+
+const sim_stats_t *sim_get_stats(void);
+
+/* Per-task priority and CPU share since sim_init(). */
+void sim_print_tasks(FILE *out);
+
+/* Firmware printf: echoed live when verbose, always kept in a short ring. */
+void sim_set_verbose(bool verbose);
+void sim_dump_log(FILE *out);
+
+#endif /* SIM_KERNEL_H */
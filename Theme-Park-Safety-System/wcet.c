@@ -0,0 +1,265 @@
+/***********************************************************************
+ * WCET Micro-Benchmark Harness - see wcet.h
+ ***********************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "wcet.h"
+
+#ifdef ESP_PLATFORM
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_attr.h"
+#include "rom/ets_sys.h"
+#include "xtensa/hal.h"
+#else
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define WCET_HOST_TSC 1
+#endif
+#define IRAM_ATTR
+#define WCET_HOST_EVICT_BYTES (64u * 1024 * 1024)   // Larger than any host last-level cache
+#endif
+
+/* ===================== PLATFORM ===================== */
+
+#ifdef ESP_PLATFORM
+
+static const char *const counter_unit = "cycles";
+
+static inline uint32_t counter_now(void)
+{
+    return xthal_get_ccount();
+}
+
+static float counter_ticks_per_us(void)
+{
+    return (float)ets_get_cpu_frequency();
+}
+
+static inline uint32_t mask_interrupts(void)
+{
+    return (uint32_t)portSET_INTERRUPT_MASK_FROM_ISR();
+}
+
+static inline void unmask_interrupts(uint32_t saved)
+{
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(saved);
+}
+
+/* Lives in flash (rodata), so reading it replaces the flash cache contents */
+static const uint8_t evict_buffer[WCET_EVICT_BYTES] = { 1 };
+
+static void evict_caches(void)
+{
+    const volatile uint8_t *bytes = evict_buffer;
+    for (size_t i = 0; i < WCET_EVICT_BYTES; i += 32) {   // One read per 32-byte cache line
+        (void)bytes[i];
+    }
+}
+
+/* Long cold runs must not starve the idle task and trip the task watchdog */
+static void yield_briefly(void)
+{
+    vTaskDelay(1);
+}
+
+#else /* Host */
+
+static uint64_t host_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+#ifdef WCET_HOST_TSC
+static const char *const counter_unit = "tsc";
+
+static inline uint32_t counter_now(void)
+{
+    _mm_lfence();   // Keep the body from being reordered around the read
+    uint64_t tsc = __rdtsc();
+    _mm_lfence();
+    return (uint32_t)tsc;   // Bodies are far shorter than a 32-bit wrap
+}
+
+static float counter_ticks_per_us(void)
+{
+    uint64_t start_ns = host_ns();
+    uint64_t start_tsc = __rdtsc();
+    while (host_ns() - start_ns < 50000000u) {
+    }
+    return (float)(__rdtsc() - start_tsc) / (float)((host_ns() - start_ns) / 1000.0);
+}
+#else
+static const char *const counter_unit = "ns";
+
+static inline uint32_t counter_now(void)
+{
+    return (uint32_t)host_ns();
+}
+
+static float counter_ticks_per_us(void)
+{
+    return 1000.0f;
+}
+#endif
+
+static inline uint32_t mask_interrupts(void)
+{
+    return 0;
+}
+
+static inline void unmask_interrupts(uint32_t saved)
+{
+    (void)saved;
+}
+
+static void evict_caches(void)
+{
+    static volatile uint8_t *buffer = NULL;
+    if (buffer == NULL) {
+        buffer = (volatile uint8_t *)calloc(WCET_HOST_EVICT_BYTES, 1);
+    }
+    for (size_t i = 0; i < WCET_HOST_EVICT_BYTES; i += 64) {
+        buffer[i]++;
+    }
+}
+
+static void yield_briefly(void)
+{
+}
+
+#endif /* ESP_PLATFORM */
+
+/* ===================== MEASUREMENT ===================== */
+
+static void empty_body(void *context)
+{
+    (void)context;
+}
+
+/* IRAM-resident so the harness itself never adds flash cache misses to a cold run */
+static uint32_t IRAM_ATTR measure(wcet_body_t body, void *context)
+{
+    uint32_t saved = mask_interrupts();
+    uint32_t start = counter_now();
+    body(context);
+    uint32_t end = counter_now();
+    unmask_interrupts(saved);
+    return end - start;
+}
+
+static int compare_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+/* Nearest-rank percentile of sorted samples */
+static uint32_t percentile(const uint32_t *sorted, uint32_t n, double q)
+{
+    uint32_t rank = (uint32_t)(q * n + 0.999999);
+    if (rank < 1) rank = 1;
+    if (rank > n) rank = n;
+    return sorted[rank - 1];
+}
+
+static void print_histogram(const uint32_t *sorted, uint32_t n)
+{
+    uint32_t lo = sorted[0], hi = sorted[n - 1];
+    uint32_t width = (hi - lo) / WCET_HISTOGRAM_BINS + 1;
+    uint32_t counts[WCET_HISTOGRAM_BINS] = { 0 };
+
+    for (uint32_t i = 0; i < n; i++) {
+        counts[(sorted[i] - lo) / width]++;
+    }
+    for (int b = 0; b < WCET_HISTOGRAM_BINS; b++) {
+        if (counts[b] == 0) continue;
+        int bar = (int)((counts[b] * 40 + n - 1) / n);
+        printf("    %8lu-%-8lu %6lu |", (unsigned long)(lo + b * width),
+               (unsigned long)(lo + (b + 1) * width - 1), (unsigned long)counts[b]);
+        for (int i = 0; i < bar; i++) putchar('#');
+        putchar('\n');
+    }
+}
+
+/* Times one case under one cache condition; returns true when within budget */
+static bool run_condition(const wcet_case_t *c, bool cold, uint32_t *samples, uint32_t n,
+                          uint32_t overhead, float ticks_per_us)
+{
+    if (!cold) {
+        if (c->setup) c->setup(c->context);
+        c->body(c->context);   // Prime caches and branch predictors
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        if (c->setup) c->setup(c->context);
+        if (cold) evict_caches();
+        uint32_t ticks = measure(c->body, c->context);
+        samples[i] = ticks > overhead ? ticks - overhead : 0;
+        if ((i & 127) == 127) yield_briefly();
+    }
+    qsort(samples, n, sizeof(uint32_t), compare_u32);
+
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < n; i++) total += samples[i];
+    double mean = (double)total / n;
+    uint32_t p50 = percentile(samples, n, 0.50), p90 = percentile(samples, n, 0.90);
+    uint32_t p99 = percentile(samples, n, 0.99), p999 = percentile(samples, n, 0.999);
+    uint32_t max = samples[n - 1];
+    double max_us = max / ticks_per_us;
+    bool pass = max_us <= c->budget_us;
+    const char *cache = cold ? "cold" : "warm";
+
+    printf("\n%s (%s cache, %lu runs, %s)\n", c->name, cache, (unsigned long)n, counter_unit);
+    printf("  min %lu  p50 %lu  p90 %lu  p99 %lu  p99.9 %lu  max %lu  mean %.1f\n",
+           (unsigned long)samples[0], (unsigned long)p50, (unsigned long)p90,
+           (unsigned long)p99, (unsigned long)p999, (unsigned long)max, mean);
+    printf("  max %.3f us, budget %.3f us -> %s\n", max_us, c->budget_us, pass ? "PASS" : "OVER BUDGET");
+    print_histogram(samples, n);
+    printf("WCET {\"case\":\"%s\",\"cache\":\"%s\",\"n\":%lu,\"unit\":\"%s\",\"ticks_per_us\":%.1f,"
+           "\"min\":%lu,\"p50\":%lu,\"p90\":%lu,\"p99\":%lu,\"p999\":%lu,\"max\":%lu,"
+           "\"mean_us\":%.3f,\"p99_us\":%.3f,\"max_us\":%.3f,\"budget_us\":%.3f,\"pass\":%s}\n",
+           c->name, cache, (unsigned long)n, counter_unit, ticks_per_us,
+           (unsigned long)samples[0], (unsigned long)p50, (unsigned long)p90, (unsigned long)p99,
+           (unsigned long)p999, (unsigned long)max,
+           mean / ticks_per_us, p99 / ticks_per_us, max_us, c->budget_us, pass ? "true" : "false");
+    return pass;
+}
+
+int wcet_run(const wcet_case_t *cases, size_t count, uint32_t iterations)
+{
+    uint32_t *samples = (uint32_t *)malloc(iterations * sizeof(uint32_t));
+    if (samples == NULL || iterations == 0) {
+        printf("WCET harness: cannot allocate %lu samples\n", (unsigned long)iterations);
+        free(samples);
+        return -1;
+    }
+    float ticks_per_us = counter_ticks_per_us();
+
+    /* Cost of the timing itself, removed from every sample */
+    uint32_t overhead = UINT32_MAX;
+    for (int i = 0; i < 1000; i++) {
+        uint32_t ticks = measure(empty_body, NULL);
+        if (ticks < overhead) overhead = ticks;
+    }
+    printf("WCET harness: %lu runs per condition, %.1f %s/us, timing overhead %lu %s\n",
+           (unsigned long)iterations, ticks_per_us, counter_unit, (unsigned long)overhead, counter_unit);
+
+    int passed = 0, failed = 0;
+    for (size_t c = 0; c < count; c++) {
+        for (int cold = 0; cold <= 1; cold++) {
+            if (run_condition(&cases[c], cold, samples, iterations, overhead, ticks_per_us)) {
+                passed++;
+            } else {
+                failed++;
+            }
+            yield_briefly();
+        }
+    }
+    printf("\nWCET-SUMMARY pass=%d fail=%d\n", passed, failed);
+    free(samples);
+    return failed;
+}